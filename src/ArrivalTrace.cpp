@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ArrivalTrace.h"
+
+// Number of bytes of the trace passed by the cursor after which their pages are released, a multiple of the page size
+constexpr size_t RELEASE_SIZE = size_t{1} << 24;
+
+/**
+ * Constructor for the ArrivalTrace, which has no arrivals until a file is opened
+ */
+ArrivalTrace::ArrivalTrace() {
+    this->arrival_times = nullptr;
+    this->num_arrivals = 0;
+    this->mapped_size = 0;
+    this->cursor = 0;
+    this->released_size = 0;
+}
+
+/**
+ * Destructor of the ArrivalTrace, which unmaps its file
+ */
+ArrivalTrace::~ArrivalTrace() {
+    if (this->mapped_size > 0) {
+        munmap(const_cast<double *>(this->arrival_times), this->mapped_size);
+    }
+}
+
+/**
+ * Memory maps a binary file of arrival times, without reading it
+ * @param file_name path and name of the file to map
+ * @return 0 if successful, nonzero otherwise
+ */
+int ArrivalTrace::open(const std::string &file_name) {
+    // Open the file and check that it holds whole arrival times
+    const int file = ::open(file_name.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cout << "error: failure to open " << file_name << " file!" << std::endl;
+        return 1;
+    }
+    struct stat file_status{};
+    if (fstat(file, &file_status) != 0 || file_status.st_size % sizeof(double) != 0) {
+        std::cout << "error: " << file_name << " is not a file of 64-bit arrival times!" << std::endl;
+        close(file);
+        return 1;
+    }
+
+    // Map the file, unless it is empty, and tell the kernel that it will be read in order so that it reads ahead
+    this->num_arrivals = file_status.st_size / sizeof(double);
+    this->mapped_size = file_status.st_size;
+    if (this->mapped_size > 0) {
+        void *mapping = mmap(nullptr, this->mapped_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            std::cout << "error: failure to map " << file_name << " file!" << std::endl;
+            this->num_arrivals = 0;
+            this->mapped_size = 0;
+            close(file);
+            return 1;
+        }
+        madvise(mapping, this->mapped_size, MADV_SEQUENTIAL);
+        this->arrival_times = static_cast<const double *>(mapping);
+    }
+
+    // The mapping stays valid after the file is closed
+    close(file);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Moves the cursor to the first arrival at or after a time, with a binary search that only touches the pages it probes
+ * @param time the time in seconds
+ * @return 0 if successful, nonzero otherwise
+ */
+int ArrivalTrace::seek(const double time) {
+    this->cursor = std::lower_bound(this->arrival_times, this->arrival_times + this->num_arrivals, time) -
+                   this->arrival_times;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Checks whether the trace has an arrival left at the cursor
+ * @return true if there is an arrival left, false otherwise
+ */
+bool ArrivalTrace::hasArrival() const {
+    return this->cursor < this->num_arrivals;
+}
+
+/**
+ * Getter for the time of the arrival at the cursor, which must exist
+ * @return the arrival time in seconds
+ */
+double ArrivalTrace::getArrivalTime() const {
+    return this->arrival_times[this->cursor];
+}
+
+/**
+ * Moves the cursor to the next arrival, releasing the pages of the trace it has passed in large blocks so that the
+ * memory used by a long replay stays bounded
+ * @return 0 if successful, nonzero otherwise
+ */
+int ArrivalTrace::advance() {
+    this->cursor++;
+    const size_t passed_size = this->cursor * sizeof(double);
+    if (passed_size - this->released_size >= RELEASE_SIZE) {
+        const size_t release_end = passed_size - passed_size % RELEASE_SIZE;
+        madvise(reinterpret_cast<char *>(const_cast<double *>(this->arrival_times)) + this->released_size,
+                release_end - this->released_size, MADV_DONTNEED);
+        this->released_size = release_end;
+    }
+
+    // Return with no errors
+    return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_ARRIVALTRACE_H
+#define CA_TRAFFIC_SIMULATION_ARRIVALTRACE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * Class for a recorded trace of the arrival times of the Vehicles at the start of a Lane, stored in a binary file of
+ * ascending 64-bit floating point times in seconds. The file is memory mapped and read sequentially from a cursor, so
+ * that traces much larger than the memory can be replayed: the pages already passed are released as the cursor moves.
+ */
+class ArrivalTrace {
+    const double *arrival_times;
+    size_t num_arrivals;
+    size_t mapped_size;
+    size_t cursor;
+    size_t released_size;
+
+public:
+    ArrivalTrace();
+
+    ~ArrivalTrace();
+
+    int open(const std::string &file_name);
+
+    int seek(double time);
+
+    [[nodiscard]] bool hasArrival() const;
+
+    [[nodiscard]] double getArrivalTime() const;
+
+    int advance();
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_ARRIVALTRACE_H
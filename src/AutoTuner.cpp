@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <omp.h>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "AutoTuner.h"
+#include "Simulation.h"
+
+/**
+ * Reads the model of the processor from the kernel, with the characters that separate the fields of the cache replaced
+ * @return the model of the processor, "unknown" if unknown
+ */
+static std::string readProcessorModel() {
+    std::ifstream file("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            std::string model = line.substr(line.find(':') + 2);
+            std::replace_if(model.begin(), model.end(), [](const char c) { return c == ',' || c == ' '; }, '_');
+            return model;
+        }
+    }
+    return "unknown";
+}
+
+/**
+ * Parses a number field of a line of the cache file, the whole field being the number
+ * @param field the field
+ * @param value_ptr pointer to the number
+ * @return 0 if successful, nonzero if the field is not a number
+ */
+template<typename T>
+static int parseCacheField(const std::string &field, T *value_ptr) {
+    std::istringstream field_stream(field);
+    field_stream >> *value_ptr;
+    return !field_stream.fail() && field_stream.eof() ? 0 : 1;
+}
+
+/**
+ * Constructor for the AutoTuner, which keys the scenario by its shape and the hardware of the first process: the
+ * engine, boundary condition, Lanes, sites, initial fill, source of the demand and maximum speed, the number of
+ * processes, the processor model and its number of cores
+ * @param inputs instance of the Inputs class with the simulation inputs
+ * @param process_data the rank and size of the MPI process
+ */
+AutoTuner::AutoTuner(const Inputs &inputs, const ProcessData &process_data) : process_data(process_data) {
+    this->inputs = inputs;
+    std::stringstream key;
+    key << "engine" << inputs.engine << "/boundary" << inputs.boundary << "/" << inputs.num_lanes << "x"
+            << inputs.length << "/fill" << inputs.percent_full << "/demand" << inputs.demand << "/vmax"
+            << inputs.max_speed << "/classes" << inputs.vehicle_classes.size() << "/np" << process_data.getSize() << "/"
+            << readProcessorModel() << "/cores" << omp_get_num_procs();
+    this->key = key.str();
+}
+
+/**
+ * Gets the configurations of the engine that simulate the same scenario as the inputs, the same on all processes
+ * @return the candidate configurations, starting with the one of the inputs
+ */
+std::vector<TuneCandidate> AutoTuner::getCandidates() const {
+    // The threads are tried in powers of two up to the cores of the first process and the Lanes
+    int num_cores = omp_get_num_procs();
+    MPI_Bcast(&num_cores, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> thread_counts;
+    const int max_threads = std::max(1, std::min(num_cores, this->inputs.num_lanes));
+    for (int t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<TuneCandidate> candidates;
+    const Inputs &in = this->inputs;
+    candidates.push_back({in.engine, in.num_threads, in.kernel, in.halo_interval});
+    if (in.engine == ENGINE_REFERENCE || in.engine == ENGINE_SWEEP) {
+        // The Vehicle classes are only simulated by the reference engine, whose lane switches only use the threads with
+        // a seed
+        for (const int t: thread_counts) {
+            if (t == 1 || in.seed != 0) {
+                candidates.push_back({ENGINE_REFERENCE, t, in.kernel, in.halo_interval});
+            }
+            if (in.vehicle_classes.empty()) {
+                candidates.push_back({ENGINE_SWEEP, t, 0, in.halo_interval});
+                candidates.push_back({ENGINE_SWEEP, t, 1, in.halo_interval});
+            }
+        }
+    } else if (in.engine == ENGINE_MULTI_SPIN) {
+        for (const int t: thread_counts) {
+            candidates.push_back({ENGINE_MULTI_SPIN, t, in.kernel, in.halo_interval});
+        }
+    } else if (in.engine == ENGINE_HALO && this->process_data.getSize() > 1) {
+        // The halos must stay within the sites of the neighbour processes
+        const int radius = std::max(in.max_speed + in.look_other_backward + 1, 2 * in.max_speed + 1);
+        for (int interval = 1; interval <= MAX_TUNED_HALO_INTERVAL; interval *= 2) {
+            if (interval * radius <= in.length / this->process_data.getSize()) {
+                candidates.push_back({ENGINE_HALO, in.num_threads, in.kernel, interval});
+            }
+        }
+    }
+
+    // Leave out the repeats of the configuration of the inputs
+    candidates.erase(std::remove_if(candidates.begin() + 1, candidates.end(), [&](const TuneCandidate &c) {
+        return c.engine == in.engine && c.num_threads == in.num_threads && c.kernel == in.kernel &&
+               c.halo_interval == in.halo_interval;
+    }), candidates.end());
+    return candidates;
+}
+
+/**
+ * Benchmarks a configuration of the engine on the inputs: the first half of the tuning steps bring the road towards its
+ * steady state and the second half is timed, on the slowest process
+ * @param candidate the configuration of the engine
+ * @return the number of steps per second
+ */
+double AutoTuner::benchmark(const TuneCandidate &candidate) const {
+    Inputs candidate_inputs = this->inputs;
+    candidate_inputs.engine = candidate.engine;
+    candidate_inputs.num_threads = candidate.num_threads;
+    candidate_inputs.kernel = candidate.kernel;
+    candidate_inputs.halo_interval = candidate.halo_interval;
+    candidate_inputs.feed_interval = 0;
+    candidate_inputs.snapshot_interval = 0;
+
+    auto *simulation_ptr = new Simulation(candidate_inputs, this->process_data);
+    const int num_warmup_steps = this->inputs.tune_steps / 2;
+    const int num_timed_steps = std::max(1, this->inputs.tune_steps - num_warmup_steps);
+    simulation_ptr->step(num_warmup_steps);
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    simulation_ptr->step(num_timed_steps);
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    delete simulation_ptr;
+
+    double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()) /
+                     1000000.0;
+    std::vector<double> all_elapsed(this->process_data.getSize());
+    MPI_Allgather(&elapsed, 1, MPI_DOUBLE, all_elapsed.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+    elapsed = *std::max_element(all_elapsed.begin(), all_elapsed.end());
+    return num_timed_steps / std::max(elapsed, 1e-9);
+}
+
+/**
+ * Reads the cached choice for the key of the scenario from the cache file, one choice per line as
+ * "key,engine,num_threads,kernel,halo_interval,steps_per_second", the last valid line of the key winning. The lines
+ * with missing or malformed fields, as left by an interrupted write or an edit, are skipped.
+ * @param file_name path and name of the cache file
+ * @param candidate_ptr pointer to the cached configuration of the engine
+ * @param rate_ptr pointer to the cached number of steps per second
+ * @return 0 if the key was found, nonzero otherwise
+ */
+int AutoTuner::readCache(const std::string &file_name, TuneCandidate *candidate_ptr, double *rate_ptr) const {
+    std::ifstream file(file_name);
+    std::string line;
+    int status = 1;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::stringstream line_stream(line);
+        std::string field;
+        while (std::getline(line_stream, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 6 || fields[0] != this->key) {
+            continue;
+        }
+        TuneCandidate candidate{};
+        double rate = 0.0;
+        if (parseCacheField(fields[1], &candidate.engine) != 0 ||
+            parseCacheField(fields[2], &candidate.num_threads) != 0 ||
+            parseCacheField(fields[3], &candidate.kernel) != 0 ||
+            parseCacheField(fields[4], &candidate.halo_interval) != 0 || parseCacheField(fields[5], &rate) != 0 ||
+            candidate.num_threads < 1 || candidate.halo_interval < 1) {
+            continue;
+        }
+        *candidate_ptr = candidate;
+        *rate_ptr = rate;
+        status = 0;
+    }
+    return status;
+}
+
+/**
+ * Appends the choice for the key of the scenario to the cache file
+ * @param file_name path and name of the cache file
+ * @param candidate the chosen configuration of the engine
+ * @param rate the number of steps per second of the configuration
+ * @return 0 if successful, nonzero otherwise
+ */
+int AutoTuner::writeCache(const std::string &file_name, const TuneCandidate &candidate, const double rate) const {
+    std::ofstream file(file_name, std::ios::app);
+    if (!file) {
+        std::cout << "error: failure to write \"" << file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    file << this->key << "," << candidate.engine << "," << candidate.num_threads << "," << candidate.kernel << ","
+            << candidate.halo_interval << "," << rate << std::endl;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Picks the fastest configuration of the engine for the inputs, from the cache of the first process or by benchmarking
+ * the candidates, and writes it into the inputs. All the processes pick the same configuration.
+ * @param inputs_ptr pointer to the inputs, whose engine, threads, kernel and halo interval are set to the choice
+ * @return 0 if successful, nonzero otherwise
+ */
+int AutoTuner::tune(Inputs *inputs_ptr) const {
+    const bool first = this->process_data.getRank() == 0;
+    const std::string cache_file = "cats-tune-cache.txt";
+
+    // Share the cached choice of the first process, if it has one
+    TuneCandidate best{};
+    double best_rate = 0.0;
+    int cached = first && this->readCache(cache_file, &best, &best_rate) == 0 ? 1 : 0;
+    MPI_Bcast(&cached, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (cached != 0) {
+        MPI_Bcast(&best, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    } else {
+        const std::vector<TuneCandidate> candidates = this->getCandidates();
+        if (candidates.size() == 1) {
+            if (first) {
+                std::cout << "auto-tune: nothing to tune for engine " << this->inputs.engine << " on "
+                        << this->process_data.getSize() << " processes" << std::endl;
+            }
+            return 0;
+        }
+        for (const auto &candidate: candidates) {
+            const double rate = this->benchmark(candidate);
+            if (first) {
+                std::cout << "auto-tune: engine " << candidate.engine << ", " << candidate.num_threads
+                        << " threads, kernel " << candidate.kernel << ", halo interval " << candidate.halo_interval
+                        << ": " << rate << " [iter/s]" << std::endl;
+            }
+            if (rate > best_rate) {
+                best = candidate;
+                best_rate = rate;
+            }
+        }
+        if (first) {
+            this->writeCache(cache_file, best, best_rate);
+        }
+    }
+
+    inputs_ptr->engine = best.engine;
+    inputs_ptr->num_threads = best.num_threads;
+    inputs_ptr->kernel = best.kernel;
+    inputs_ptr->halo_interval = best.halo_interval;
+    if (first) {
+        std::cout << "auto-tune: chose engine " << best.engine << ", " << best.num_threads << " threads, kernel "
+                << best.kernel << ", halo interval " << best.halo_interval << " (" << best_rate << " [iter/s]"
+                << (cached != 0 ? ", cached" : "") << ") for " << this->key << std::endl;
+    }
+
+    // Return with no errors
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_AUTOTUNER_H
+#define CA_TRAFFIC_SIMULATION_AUTOTUNER_H
+
+#include <string>
+#include <vector>
+
+#include "Inputs.h"
+#include "ProcessData.h"
+
+// Largest number of steps between the halo exchanges tried by the auto-tuner
+constexpr int MAX_TUNED_HALO_INTERVAL = 16;
+
+/**
+ * Structure for a configuration of the engine tried by the auto-tuner
+ */
+struct TuneCandidate {
+    int engine;
+    int num_threads;
+    int kernel;
+    int halo_interval;
+};
+
+/**
+ * Class for the auto-tuner, which benchmarks the configurations of the engine that simulate the same scenario on the
+ * actual inputs for a few steps at startup and picks the fastest one. The reference and fused lane sweep engines are
+ * interchangeable, with any number of threads up to the Lanes and the cores and either sweep kernel, the halo exchange
+ * engine is tuned on its exchange interval, which sets the width of its halos, and the multi-spin engine on its
+ * threads. The choice is cached in "cats-tune-cache.txt", keyed by the shape and the demand of the scenario and the
+ * hardware, so that the next runs of the same scenario skip the benchmarks.
+ */
+class AutoTuner {
+    Inputs inputs;
+    ProcessData process_data;
+    std::string key;
+
+    [[nodiscard]] std::vector<TuneCandidate> getCandidates() const;
+
+    [[nodiscard]] double benchmark(const TuneCandidate &candidate) const;
+
+    int readCache(const std::string &file_name, TuneCandidate *candidate_ptr, double *rate_ptr) const;
+
+    int writeCache(const std::string &file_name, const TuneCandidate &candidate, double rate) const;
+
+public:
+    AutoTuner(const Inputs &inputs, const ProcessData &process_data);
+
+    ~AutoTuner() = default;
+
+    int tune(Inputs *inputs_ptr) const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_AUTOTUNER_H
@@ -38,12 +38,38 @@ int CDF::read_cdf(const std::string &file_name) {
     return 0;
 }
 
+/**
+ * Sets the data for the cumulative distribution function from memory
+ * @param points the values in ascending order
+ * @param probabilities the distribution function at each value
+ * @return 0 if successful, nonzero otherwise
+ */
+int CDF::setPoints(const std::vector<float> &points, const std::vector<float> &probabilities) {
+    if (points.empty() || points.size() != probabilities.size()) {
+        std::cout << "error: the CDF needs a cumulative probability for each of its points!" << std::endl;
+        return 1;
+    }
+    this->x = points;
+    this->cdf = probabilities;
+
+    // Return with no errors
+    return 0;
+}
+
 /**
  * Sampled a point from the cumulative distribution function
  * @return sampled point from the distribution
  */
 double CDF::query() const {
-    double u = static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+    return this->query(static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+}
+
+/**
+ * Finds the point of the cumulative distribution function at a given cumulative probability
+ * @param u the cumulative probability, a uniform random number to sample the distribution
+ * @return the point of the distribution
+ */
+double CDF::query(const double u) const {
     for (int i = 0; i < static_cast<int>(this->cdf.size()); i++) {
         if (this->cdf[i] >= u) {
             return this->x[i];
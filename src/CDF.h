@@ -18,7 +18,11 @@ class CDF {
 public:
     int read_cdf(const std::string &file_name);
 
+    int setPoints(const std::vector<float> &points, const std::vector<float> &probabilities);
+
     [[nodiscard]] double query() const;
+
+    [[nodiscard]] double query(double u) const;
 };
 
 
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "Demand.h"
+
+// Length of the day over which the periods of the demand schedule repeat, in seconds
+constexpr double DAY_LENGTH = 86400.0;
+
+/**
+ * Constructor for the Demand, which loads the CDFs of the interarrival times or maps the arrival traces of the Lanes
+ * @param inputs instance of the Inputs class with simulation inputs
+ */
+Demand::Demand(const Inputs &inputs) : random(inputs) {
+    this->source = inputs.demand;
+    this->step_size = inputs.step_size;
+    this->start_time = inputs.demand_start_time;
+    this->num_spawns.resize(inputs.num_lanes, 0);
+
+    if (this->source == DEMAND_TRACE) {
+        // Map the arrival trace of each Lane and move it to the start of the demand clock
+        for (int i = 0; i < inputs.num_lanes; i++) {
+            this->traces.push_back(new ArrivalTrace());
+            if (const int status = this->traces.back()->open("arrivals-lane-" + std::to_string(i) + ".bin");
+                status != 0) {
+                throw std::exception();
+            }
+            this->traces.back()->seek(this->start_time);
+        }
+    } else if (this->source == DEMAND_SCHEDULE) {
+        // Read the start of each period of the day and the file with the CDF of its interarrival times
+        std::ifstream file("demand-schedule.dat");
+        if (!file) {
+            std::cout << "error: failure to open demand-schedule.dat file!" << std::endl;
+            throw std::exception();
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            const double period_start = std::stod(line.substr(0, line.find(',')));
+            if (period_start < 0.0 || period_start >= DAY_LENGTH ||
+                (this->period_starts.empty() ? period_start != 0.0 : period_start <= this->period_starts.back())) {
+                std::cout << "error: the periods of the demand schedule must start at 0 and increase through the day!"
+                        << std::endl;
+                throw std::exception();
+            }
+            this->period_starts.push_back(period_start);
+            this->cdfs.push_back(new CDF());
+            if (const int status = this->cdfs.back()->read_cdf(line.substr(line.find(',') + 1)); status != 0) {
+                throw std::exception();
+            }
+        }
+        if (this->period_starts.empty()) {
+            std::cout << "error: the demand schedule has no periods!" << std::endl;
+            throw std::exception();
+        }
+    } else {
+        // Use the single CDF of the interarrival times for the whole day, given in memory or read from its file
+        this->period_starts.push_back(0.0);
+        this->cdfs.push_back(new CDF());
+        if (!inputs.interarrival_times.empty()) {
+            if (const int status = this->cdfs.back()->setPoints(inputs.interarrival_times,
+                                                                inputs.interarrival_probabilities); status != 0) {
+                throw std::exception();
+            }
+        } else if (const int status = this->cdfs.back()->read_cdf("interarrival-cdf.dat"); status != 0) {
+            throw std::exception();
+        }
+    }
+}
+
+/**
+ * Destructor of the Demand
+ */
+Demand::~Demand() {
+    for (const auto &cdf: this->cdfs) {
+        delete cdf;
+    }
+    for (const auto &trace: this->traces) {
+        delete trace;
+    }
+}
+
+/**
+ * Converts a simulation time to the time of the demand clock
+ * @param time the simulation time
+ * @return the demand clock time in seconds
+ */
+double Demand::getClockTime(const int time) const {
+    return this->start_time + time * this->step_size;
+}
+
+/**
+ * Computes the number of steps to count down after a simulation time until the step at or after the next arrival of
+ * the trace of a Lane, spawning on the step after the countdown reaches zero
+ * @param lane the number of the Lane
+ * @param time the simulation time
+ * @return the number of steps to spawn, which is never reached if the trace has no arrivals left
+ */
+int Demand::getStepsToArrival(const int lane, const int time) const {
+    if (!this->traces[lane]->hasArrival()) {
+        return std::numeric_limits<int>::max();
+    }
+    const double arrival_step = std::ceil((this->traces[lane]->getArrivalTime() - this->start_time) / this->step_size);
+    return static_cast<int>(std::clamp(arrival_step - time - 1.0, 0.0,
+                                       static_cast<double>(std::numeric_limits<int>::max())));
+}
+
+/**
+ * Getter for the number of steps to spawn of a Lane at the start of the simulation, which spawns on the first step
+ * unless the arrivals are replayed from a trace
+ * @param lane the number of the Lane
+ * @return the number of steps to spawn
+ */
+int Demand::getInitialStepsToSpawn(const int lane) const {
+    if (this->source == DEMAND_TRACE) {
+        return this->getStepsToArrival(lane, 0);
+    }
+    return 0;
+}
+
+/**
+ * "Schedules" the next spawn of a Lane after a Vehicle was spawned in it, either by sampling an interarrival time from
+ * the CDF of the period of the day, keyed by the Lane and the number of the spawn when the simulation has a seed, or by
+ * moving to the next arrival of the trace
+ * @param lane the number of the Lane
+ * @param time the simulation time of the spawn
+ * @return the number of steps to spawn
+ */
+int Demand::drawStepsToSpawn(const int lane, const int time) {
+    if (this->source == DEMAND_TRACE) {
+        this->traces[lane]->advance();
+        return this->getStepsToArrival(lane, time);
+    }
+
+    // Find the period of the day the demand clock is in
+    double time_of_day = std::fmod(this->getClockTime(time), DAY_LENGTH);
+    if (time_of_day < 0.0) {
+        time_of_day += DAY_LENGTH;
+    }
+    const auto period = std::upper_bound(this->period_starts.begin(), this->period_starts.end(), time_of_day) -
+                        this->period_starts.begin() - 1;
+    if (this->random.isEnabled()) {
+        const double u = this->random.draw(lane, this->num_spawns[lane]++, STREAM_INTERARRIVAL);
+        return static_cast<int>(this->cdfs[period]->query(u) / this->step_size);
+    }
+    return static_cast<int>(this->cdfs[period]->query() / this->step_size);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_DEMAND_H
+#define CA_TRAFFIC_SIMULATION_DEMAND_H
+
+#include <vector>
+
+#include "Inputs.h"
+#include "CDF.h"
+#include "ArrivalTrace.h"
+#include "KeyedRandom.h"
+
+/**
+ * Class for the demand of Vehicles entering the Lanes of the open road, which schedules the spawns of each Lane. The
+ * interarrival times are either sampled from a single CDF, sampled from the CDF of the period of the day the demand clock
+ * is in, or replayed from a recorded trace of arrival times per Lane. The demand clock starts at the demand start time
+ * and advances by the step size each time step.
+ *
+ * A spawn is attempted when the number of steps to spawn of a Lane counts down to zero, and repeated every step until
+ * the first site of the Lane is empty, so the arrivals of a trace queue up behind a blocked entrance.
+ */
+class Demand {
+    int source;
+    double step_size;
+    double start_time;
+    std::vector<double> period_starts;
+    std::vector<CDF *> cdfs;
+    std::vector<ArrivalTrace *> traces;
+    KeyedRandom random;
+    std::vector<long> num_spawns;
+
+    [[nodiscard]] double getClockTime(int time) const;
+
+    [[nodiscard]] int getStepsToArrival(int lane, int time) const;
+
+public:
+    explicit Demand(const Inputs &inputs);
+
+    ~Demand();
+
+    [[nodiscard]] int getInitialStepsToSpawn(int lane) const;
+
+    int drawStepsToSpawn(int lane, int time);
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_DEMAND_H
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <cmath>
+#include <string>
+
+#include "Experiment.h"
+#include "Simulation.h"
+#include "Statistic.h"
+
+/**
+ * Constructor for the Experiment
+ * @param inputs instance of the Inputs class with the inputs of the simulation and of its replicas
+ * @param paired_inputs instance of the Inputs class with the inputs of the paired scenario, if there is one
+ * @param process_data Contains the rank and size of the MPI process, represented
+ *                     by an instance of the `ProcessData` class. This is used to
+ *                     manage distributed simulation across multiple processes.
+ */
+Experiment::Experiment(const Inputs &inputs, const Inputs &paired_inputs, const ProcessData &process_data)
+    : process_data(process_data) {
+    this->inputs = inputs;
+    this->paired_inputs = paired_inputs;
+
+    // The snapshot file holds the first replica of the scenario only
+    this->paired_inputs.snapshot_interval = 0;
+}
+
+/**
+ * Runs a replica of a scenario with the seed of the replica
+ * @param scenario_inputs instance of the Inputs class with the inputs of the scenario
+ * @param replica the number of the replica
+ * @param has_result_ptr pointer to whether the process has the result of the replica
+ * @return the result of the replica
+ */
+double Experiment::runReplica(const Inputs &scenario_inputs, const int replica, bool *has_result_ptr) const {
+    Inputs replica_inputs = scenario_inputs;
+    replica_inputs.num_replicas = 1;
+    replica_inputs.paired_scenario = 0;
+    replica_inputs.antithetic = 0;
+    replica_inputs.seed = 0;
+    if (replica > 0) {
+        replica_inputs.snapshot_interval = 0;
+    }
+    if (this->inputs.seed != 0) {
+        if (this->inputs.antithetic != 0) {
+            replica_inputs.seed = this->inputs.seed + replica / 2;
+            replica_inputs.antithetic = replica % 2;
+        } else {
+            replica_inputs.seed = this->inputs.seed + replica;
+        }
+    }
+
+    auto *simulation_ptr = new Simulation(replica_inputs, this->process_data);
+    simulation_ptr->run_simulation(false);
+    *has_result_ptr = simulation_ptr->hasResult();
+    const double result = simulation_ptr->getResult();
+    delete simulation_ptr;
+    return result;
+}
+
+/**
+ * Runs the replicas of the experiment and prints the confidence intervals of the results of each scenario and of
+ * their difference
+ * @return 0 if successful, nonzero otherwise
+ */
+int Experiment::run() const {
+    // A single simulation reports its own performance and results
+    if (this->inputs.num_replicas == 1 && this->inputs.paired_scenario == 0) {
+        auto *simulation_ptr = new Simulation(this->inputs, this->process_data);
+        simulation_ptr->run_simulation(true);
+        delete simulation_ptr;
+        return 0;
+    }
+
+    const bool paired = this->inputs.paired_scenario != 0;
+    const bool antithetic = this->inputs.antithetic != 0;
+    const std::string name = this->inputs.boundary == BOUNDARY_PERIODIC ? "flow" : "time on road";
+
+    // Run the replicas, averaging the two replicas of each antithetic pair into one independent sample
+    auto *results = new Statistic();
+    auto *paired_results = new Statistic();
+    auto *differences = new Statistic();
+    bool has_result = false;
+    double first_result = 0.0;
+    double first_paired_result = 0.0;
+    for (int r = 0; r < this->inputs.num_replicas; r++) {
+        double result = this->runReplica(this->inputs, r, &has_result);
+        double paired_result = paired ? this->runReplica(this->paired_inputs, r, &has_result) : 0.0;
+        if (has_result) {
+            std::cout << "replica " << r << ": " << name << "=" << result;
+            if (paired) {
+                std::cout << ", paired " << name << "=" << paired_result;
+            }
+            std::cout << std::endl;
+        }
+
+        if (antithetic) {
+            if (r % 2 == 0) {
+                first_result = result;
+                first_paired_result = paired_result;
+                continue;
+            }
+            result = 0.5 * (first_result + result);
+            paired_result = 0.5 * (first_paired_result + paired_result);
+        }
+        results->addValue(result);
+        if (paired) {
+            paired_results->addValue(paired_result);
+            differences->addValue(paired_result - result);
+        }
+    }
+
+    // Print the confidence intervals on the process with the results
+    if (has_result) {
+        std::cout << "--- Experiment Results ---" << std::endl;
+        std::cout << "replicas: " << this->inputs.num_replicas;
+        if (antithetic) {
+            std::cout << " in " << results->getNumSamples() << " antithetic pairs";
+        }
+        if (this->inputs.seed != 0) {
+            std::cout << ", seeds from " << this->inputs.seed;
+        }
+        std::cout << std::endl;
+        std::cout << name << ": avg=" << results->getAverage() << ", 95% half-width="
+                << results->getConfidenceHalfWidth() << ", N=" << results->getNumSamples() << std::endl;
+        if (paired) {
+            std::cout << "paired " << name << ": avg=" << paired_results->getAverage() << ", 95% half-width="
+                    << paired_results->getConfidenceHalfWidth() << ", N=" << paired_results->getNumSamples()
+                    << std::endl;
+
+            // Compare with the half-width of the difference of independent scenarios with the same variances
+            const double independent_half_width = std::sqrt(
+                std::pow(results->getConfidenceHalfWidth(), 2) + std::pow(paired_results->getConfidenceHalfWidth(), 2));
+            std::cout << "paired difference: avg=" << differences->getAverage() << ", 95% half-width="
+                    << differences->getConfidenceHalfWidth() << ", N=" << differences->getNumSamples()
+                    << " (independent scenarios: 95% half-width=" << independent_half_width << ")" << std::endl;
+        }
+    }
+
+    delete results;
+    delete paired_results;
+    delete differences;
+
+    // Return with no errors
+    return 0;
+}
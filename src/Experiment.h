@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_EXPERIMENT_H
+#define CA_TRAFFIC_SIMULATION_EXPERIMENT_H
+
+#include "Inputs.h"
+#include "ProcessData.h"
+
+/**
+ * Class for an experiment made of replicas of a simulation, optionally paired with the replicas of a second scenario.
+ * With a seed, the replica r has the seed plus r, or plus r / 2 with antithetic pairs of replicas, the odd replica of a
+ * pair drawing one minus the random numbers of the even one. The paired replica of the second scenario has the same
+ * seed, so that both scenarios share their random numbers, and the confidence interval of their difference is computed
+ * from the differences of the paired replicas.
+ */
+class Experiment {
+    Inputs inputs;
+    Inputs paired_inputs;
+    ProcessData process_data;
+
+    double runReplica(const Inputs &scenario_inputs, int replica, bool *has_result_ptr) const;
+
+public:
+    Experiment(const Inputs &inputs, const Inputs &paired_inputs, const ProcessData &process_data);
+
+    ~Experiment() = default;
+
+    int run() const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_EXPERIMENT_H
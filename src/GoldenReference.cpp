@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "GoldenReference.h"
+#include "Simulation.h"
+#include "Statistic.h"
+
+/**
+ * Checks whether all the processes agree, each on its own share of the simulation
+ * @param agree whether the process agrees
+ * @param num_processes the number of processes
+ * @return whether every process agrees
+ */
+static bool allAgree(const bool agree, const int num_processes) {
+    const int flag = agree ? 1 : 0;
+    std::vector<int> flags(num_processes);
+    MPI_Allgather(&flag, 1, MPI_INT, flags.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    return std::all_of(flags.begin(), flags.end(), [](const int f) { return f != 0; });
+}
+
+/**
+ * Gets the Kolmogorov-Smirnov distance between the empirical distributions of two sets of samples, the largest
+ * difference of their cumulative distributions
+ * @param a the first samples
+ * @param b the second samples
+ * @return the distance
+ */
+static double getKolmogorovSmirnovDistance(const Span<double> a, const Span<double> b) {
+    std::vector<double> sorted_a(a.begin(), a.end());
+    std::vector<double> sorted_b(b.begin(), b.end());
+    std::sort(sorted_a.begin(), sorted_a.end());
+    std::sort(sorted_b.begin(), sorted_b.end());
+    double distance = 0.0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < sorted_a.size() && j < sorted_b.size()) {
+        const double value = std::min(sorted_a[i], sorted_b[j]);
+        while (i < sorted_a.size() && sorted_a[i] == value) {
+            i++;
+        }
+        while (j < sorted_b.size() && sorted_b[j] == value) {
+            j++;
+        }
+        distance = std::max(distance, std::abs(static_cast<double>(i) / sorted_a.size() -
+                                               static_cast<double>(j) / sorted_b.size()));
+    }
+    return distance;
+}
+
+/**
+ * Gets the effective number of independent samples of a correlated series, the number of independent samples of its
+ * variance whose average would have the same confidence interval as the batch means of the series
+ * @param series the Statistic of the series
+ * @return the effective number of samples, at most the number of samples
+ */
+static double getEffectiveNumSamples(const Statistic &series) {
+    const double half_width = series.getHalfWidth(0);
+    const double num_samples = series.getNumSamples();
+    if (!std::isfinite(half_width) || half_width <= 0.0) {
+        return num_samples;
+    }
+    return std::min(num_samples, series.getVariance() * std::pow(CONFIDENCE_QUANTILE / half_width, 2));
+}
+
+/**
+ * Gets the process data the reference engine runs with to match an engine: the engines that distribute a single Road
+ * (the halo exchange engine) or the segments of a network over the processes are matched by the reference engine on
+ * the whole Road on each process, the others split the Road between the processes like the reference engine
+ * @param scenario_inputs instance of the Inputs class with the inputs of the scenario
+ * @param process_data the rank and size of the MPI process
+ * @return the process data of the reference engine
+ */
+static ProcessData getReferenceProcessData(const Inputs &scenario_inputs, const ProcessData &process_data) {
+    if (scenario_inputs.engine == ENGINE_HALO || scenario_inputs.engine == ENGINE_NETWORK) {
+        return {0, 1};
+    }
+    return process_data;
+}
+
+/**
+ * Constructor for the GoldenReference
+ * @param process_data the rank and size of the MPI process
+ */
+GoldenReference::GoldenReference(const ProcessData &process_data) : process_data(process_data) {
+}
+
+/**
+ * Loads the names of the configuration files of the scenarios of the corpus, one per line
+ * @param file_name path and name of the corpus file
+ * @param scenario_files pointer to the names of the configuration files
+ * @return 0 if successful, nonzero otherwise
+ */
+int GoldenReference::loadCorpus(const std::string &file_name, std::vector<std::string> *scenario_files) {
+    std::ifstream file(file_name);
+    if (!file) {
+        std::cout << "error: failure to open \"" << file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            scenario_files->push_back(line);
+        }
+    }
+    if (scenario_files->empty()) {
+        std::cout << "error: \"" << file_name << "\" lists no scenarios!" << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Loads the inputs of a scenario of the corpus: the lines of the base configuration file, with the lines given in the
+ * configuration file of the scenario as "<line number> <value>" replaced by their values. Empty lines and lines
+ * starting with '#' are skipped, and an empty scenario is the base configuration itself.
+ * @param base_file_name path and name of the base configuration file
+ * @param file_name path and name of the configuration file of the scenario
+ * @param scenario_inputs_ptr pointer to the inputs of the scenario
+ * @return 0 if successful, nonzero otherwise
+ */
+int GoldenReference::loadScenario(const std::string &base_file_name, const std::string &file_name,
+                                  Inputs *scenario_inputs_ptr) {
+    std::ifstream base_file(base_file_name);
+    if (!base_file) {
+        std::cout << "error: failure to open \"" << base_file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    std::vector<std::string> input_lines;
+    std::string line;
+    while (std::getline(base_file, line)) {
+        input_lines.push_back(line);
+    }
+
+    // Replace the lines the scenario overrides
+    std::ifstream file(file_name);
+    if (!file) {
+        std::cout << "error: failure to open \"" << file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream line_stream(line);
+        int line_number = 0;
+        std::string value;
+        if (!(line_stream >> line_number >> value) || line_number < 1 ||
+            line_number > static_cast<int>(input_lines.size())) {
+            std::cout << "error: \"" << line << "\" of \"" << file_name << "\" overrides no line of \""
+                    << base_file_name << "\"!" << std::endl;
+            return 1;
+        }
+        input_lines[line_number - 1] = value;
+    }
+    return scenario_inputs_ptr->loadFromLines(input_lines);
+}
+
+/**
+ * Compares an engine with the reference engine step by step on a scenario: the speeds of the sites of each Lane of the
+ * process after every step, against the same sites of the reference engine, and the measured samples once the steps
+ * are done
+ * @param scenario_inputs instance of the Inputs class with the inputs of the scenario
+ * @param agree_ptr pointer to whether the engines agree
+ * @return 0 if successful, nonzero otherwise
+ */
+int GoldenReference::compareExact(const Inputs &scenario_inputs, bool *agree_ptr) const {
+    Inputs reference_inputs = scenario_inputs;
+    reference_inputs.engine = ENGINE_REFERENCE;
+    auto *reference_ptr = new Simulation(reference_inputs,
+                                         getReferenceProcessData(scenario_inputs, this->process_data));
+    auto *simulation_ptr = new Simulation(scenario_inputs, this->process_data);
+
+    // Compare the speeds of all the sites after each step, until the first difference on any process
+    bool agree = true;
+    int step = 0;
+    int lane = 0;
+    int site = 0;
+    int reference_speed = 0;
+    int speed = 0;
+    while (step < scenario_inputs.max_time) {
+        reference_ptr->step(1);
+        simulation_ptr->step(1);
+        step++;
+        const int offset = simulation_ptr->getLaneOffset();
+        for (int i = 0; i < scenario_inputs.num_lanes && agree; i++) {
+            const Span<int8_t> reference_speeds = reference_ptr->getLaneSpeeds(i);
+            const Span<int8_t> speeds = simulation_ptr->getLaneSpeeds(i);
+            for (size_t j = 0; j < speeds.size(); j++) {
+                const int reference_site_speed = offset + j < reference_speeds.size()
+                                                     ? reference_speeds[offset + j]
+                                                     : -1;
+                if (speeds[j] != reference_site_speed) {
+                    agree = false;
+                    lane = i;
+                    site = offset + static_cast<int>(j);
+                    reference_speed = reference_site_speed;
+                    speed = speeds[j];
+                    break;
+                }
+            }
+        }
+        if (!allAgree(agree, this->process_data.getSize())) {
+            break;
+        }
+    }
+    if (!agree) {
+        std::cout << "golden reference: first difference at step " << step << " in lane " << lane << ", site " << site
+                << " on process " << this->process_data.getRank() << ": reference speed " << reference_speed
+                << ", engine speed " << speed << " (-1 = empty)" << std::endl;
+    }
+
+    // The measured samples must be the same, on the process with the results of the engine
+    bool same_samples = true;
+    if (simulation_ptr->hasResult()) {
+        const bool ring = scenario_inputs.boundary == BOUNDARY_PERIODIC;
+        const Span<double> reference_values = ring
+                                                  ? reference_ptr->getFlow().getValues()
+                                                  : reference_ptr->getTravelTime().getValues();
+        const Span<double> values = ring
+                                        ? simulation_ptr->getFlow().getValues()
+                                        : simulation_ptr->getTravelTime().getValues();
+        same_samples = values.size() == reference_values.size() &&
+                       std::equal(values.begin(), values.end(), reference_values.begin());
+        std::cout << "golden reference: " << step << " steps compared site by site, " << values.size() << " "
+                << (ring ? "flow" : "time on road") << " samples against " << reference_values.size()
+                << (same_samples ? ", identical" : ", different") << std::endl;
+    }
+    *agree_ptr = allAgree(agree && same_samples, this->process_data.getSize());
+
+    delete reference_ptr;
+    delete simulation_ptr;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Compares an engine with the reference engine statistically on a scenario, running both to the end: the difference
+ * of the averages of their samples, the flow on the ring road or the times on road, must be within the 95% confidence
+ * interval of the difference, and the distributions of the samples must pass the Kolmogorov-Smirnov test, with the
+ * effective number of independent samples of the correlated series. The samples of the multi-spin engine are the
+ * averages of its replicas, whose distribution is not compared with the samples of the steps.
+ * @param scenario_inputs instance of the Inputs class with the inputs of the scenario
+ * @param agree_ptr pointer to whether the engines agree
+ * @return 0 if successful, nonzero otherwise
+ */
+int GoldenReference::compareStatistics(const Inputs &scenario_inputs, bool *agree_ptr) const {
+    Inputs reference_inputs = scenario_inputs;
+    reference_inputs.engine = ENGINE_REFERENCE;
+    auto *reference_ptr = new Simulation(reference_inputs,
+                                         getReferenceProcessData(scenario_inputs, this->process_data));
+    auto *simulation_ptr = new Simulation(scenario_inputs, this->process_data);
+    reference_ptr->run_simulation(false);
+    simulation_ptr->run_simulation(false);
+
+    bool agree = true;
+    if (simulation_ptr->hasResult()) {
+        const bool ring = scenario_inputs.boundary == BOUNDARY_PERIODIC;
+        const bool replica_samples = scenario_inputs.engine == ENGINE_MULTI_SPIN;
+        const Statistic &reference_series = ring ? reference_ptr->getFlow() : reference_ptr->getTravelTime();
+        const Statistic &series = ring ? simulation_ptr->getFlow() : simulation_ptr->getTravelTime();
+        const std::string name = ring ? "flow" : "time on road";
+
+        // The averages, with the batch means interval of the steps and the plain interval of independent replicas
+        const double reference_half_width = reference_series.getHalfWidth(0);
+        const double half_width = replica_samples ? series.getConfidenceHalfWidth() : series.getHalfWidth(0);
+        const double difference = series.getAverage() - reference_series.getAverage();
+        const double difference_half_width = std::sqrt(std::pow(reference_half_width, 2) + std::pow(half_width, 2));
+        const bool conclusive = std::isfinite(difference_half_width);
+        agree = conclusive && std::abs(difference) <= difference_half_width;
+        std::cout << "golden reference: " << name << " avg=" << series.getAverage() << " against "
+                << reference_series.getAverage() << ", difference " << difference << " with 95% half-width "
+                << difference_half_width << (conclusive ? "" : " (too few samples)") << std::endl;
+
+        // The distributions, with the effective number of samples of each series
+        if (!replica_samples && reference_series.getNumSamples() > 0 && series.getNumSamples() > 0) {
+            const double distance = getKolmogorovSmirnovDistance(series.getValues(), reference_series.getValues());
+            const double n = getEffectiveNumSamples(reference_series);
+            const double m = getEffectiveNumSamples(series);
+            const double critical_distance = KS_CRITICAL_VALUE * std::sqrt((n + m) / (n * m));
+            agree = agree && distance <= critical_distance;
+            std::cout << "golden reference: " << name << " distribution KS distance=" << distance
+                    << " against critical " << critical_distance << " at 1% (effective samples " << n << " and " << m
+                    << ")" << std::endl;
+        }
+    }
+    *agree_ptr = allAgree(agree, this->process_data.getSize());
+
+    delete reference_ptr;
+    delete simulation_ptr;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Compares the engine of each scenario of the corpus with the reference engine, exactly when it draws the same keyed
+ * random numbers and statistically otherwise, and prints the verdicts
+ * @return 0 if the engines of all the scenarios agree with the reference engine, nonzero otherwise
+ */
+int GoldenReference::run() const {
+    const bool print = this->process_data.getRank() == 0;
+    int num_compared = 0;
+    int num_agreed = 0;
+    std::vector<std::string> scenario_files;
+    if (const int status = loadCorpus("golden-corpus.txt", &scenario_files); status != 0) {
+        return status;
+    }
+    for (const auto &file_name: scenario_files) {
+        Inputs scenario_inputs;
+        if (loadScenario("cats-input.txt", file_name, &scenario_inputs) != 0) {
+            return 1;
+        }
+        const std::string &scenario = file_name;
+
+        // The scenarios run once, without stopping early or publishing a feed
+        scenario_inputs.golden_reference = 0;
+        scenario_inputs.num_replicas = 1;
+        scenario_inputs.paired_scenario = 0;
+        scenario_inputs.target_precision = 0.0;
+        scenario_inputs.feed_interval = 0;
+        scenario_inputs.snapshot_interval = 0;
+        if (scenario_inputs.engine == ENGINE_REFERENCE) {
+            if (print) {
+                std::cout << "golden reference: scenario " << scenario << " runs the reference engine, skipped"
+                        << std::endl;
+            }
+            continue;
+        }
+
+        const bool exact = scenario_inputs.seed != 0 && (scenario_inputs.engine == ENGINE_SWEEP ||
+                                                         scenario_inputs.engine == ENGINE_HALO);
+        if (print) {
+            std::cout << "golden reference: scenario " << scenario << ", engine " << scenario_inputs.engine
+                    << (exact ? ", exact comparison" : ", statistical comparison") << std::endl;
+        }
+        bool agree = false;
+        if (const int status = exact
+                                   ? this->compareExact(scenario_inputs, &agree)
+                                   : this->compareStatistics(scenario_inputs, &agree); status != 0) {
+            return status;
+        }
+        num_compared++;
+        if (agree) {
+            num_agreed++;
+        }
+        if (print) {
+            std::cout << "golden reference: scenario " << scenario << (agree ? " PASSED" : " FAILED") << std::endl;
+        }
+    }
+    if (print) {
+        std::cout << "--- Golden Reference Results ---" << std::endl;
+        std::cout << num_agreed << " of " << num_compared << " scenarios agree with the reference engine" << std::endl;
+    }
+
+    return num_agreed == num_compared ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_GOLDENREFERENCE_H
+#define CA_TRAFFIC_SIMULATION_GOLDENREFERENCE_H
+
+#include <string>
+#include <vector>
+
+#include "Inputs.h"
+#include "ProcessData.h"
+
+// Critical value of the two-sample Kolmogorov-Smirnov test at the 1% level, and the quantile of the 95% confidence
+// intervals from which the effective number of independent samples of a correlated series is estimated
+constexpr double KS_CRITICAL_VALUE = 1.63;
+constexpr double CONFIDENCE_QUANTILE = 1.96;
+
+/**
+ * Class for the validation of the engines against the reference Vehicle/Lane engine on a corpus of scenarios, the
+ * configuration files listed in "golden-corpus.txt", each giving the lines of "cats-input.txt" it changes. The engines
+ * that draw the keyed random numbers of the reference engine, the fused lane sweep and the halo exchange engine with a
+ * seed, must agree exactly: the speeds of all the sites of all the Lanes after every step and the measured samples.
+ * The other engines must agree statistically: the difference of the averages within its 95% confidence interval, and
+ * the distributions of the samples within the Kolmogorov-Smirnov test where the samples are alike.
+ */
+class GoldenReference {
+    ProcessData process_data;
+
+    static int loadCorpus(const std::string &file_name, std::vector<std::string> *scenario_files);
+
+    static int loadScenario(const std::string &base_file_name, const std::string &file_name,
+                            Inputs *scenario_inputs_ptr);
+
+    int compareExact(const Inputs &scenario_inputs, bool *agree_ptr) const;
+
+    int compareStatistics(const Inputs &scenario_inputs, bool *agree_ptr) const;
+
+public:
+    explicit GoldenReference(const ProcessData &process_data);
+
+    ~GoldenReference() = default;
+
+    int run() const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_GOLDENREFERENCE_H
@@ -0,0 +1,644 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "HaloEngine.h"
+
+/**
+ * Constructor for the HaloEngine
+ * @param inputs instance of the Inputs class with simulation inputs
+ * @param process_data Contains the rank and size of the MPI process, represented
+ *                     by an instance of the `ProcessData` class. This is used to
+ *                     manage distributed simulation across multiple processes.
+ */
+HaloEngine::HaloEngine(const Inputs &inputs, const ProcessData &process_data) : random(inputs) {
+    // Copy the parameters of the CA rules
+    this->num_lanes = inputs.num_lanes;
+    this->length = inputs.length;
+    this->max_speed = inputs.max_speed;
+    this->look_other_backward = inputs.look_other_backward;
+    this->passing_rule = inputs.passing_rule;
+    this->prob_slow_down = inputs.prob_slow_down;
+    this->prob_change = inputs.prob_change;
+
+    // Split the sites among the processes in the same way as the Lane class, with the remainder on the last process
+    this->rank = process_data.getRank();
+    this->num_processes = process_data.getSize();
+    this->offset = this->rank * (this->length / this->num_processes);
+    this->size = this->length / this->num_processes;
+    if (this->rank == this->num_processes - 1) {
+        this->size += this->length % this->num_processes;
+    }
+
+    // The halos cover the distance the cells can influence each other over the steps between the exchanges
+    this->interval = inputs.halo_interval;
+    this->upstream_radius = this->max_speed + this->look_other_backward + 1;
+    this->downstream_radius = 2 * this->max_speed + 1;
+    this->upstream_width = this->rank > 0 ? this->interval * this->upstream_radius : 0;
+    this->downstream_width = this->rank < this->num_processes - 1 ? this->interval * this->downstream_radius : 0;
+    this->extended_size = this->upstream_width + this->size + this->downstream_width;
+    this->steps_since_exchange = 0;
+    this->num_exchanges = 0;
+    this->exchange_time = 0.0;
+    this->rebalance_interval = inputs.rebalance_interval;
+    this->rebalance_threshold = inputs.rebalance_threshold;
+    this->steps_since_rebalance = 0;
+    this->step_time = 0.0;
+    this->num_rebalances = 0;
+    this->imbalance = 0.0;
+
+    // The halos of a process must be owned by its neighbours
+    const int min_size = this->length / this->num_processes;
+    if (this->num_processes > 1 && min_size < this->interval * std::max(this->upstream_radius, this->downstream_radius)) {
+        std::cout << "error: the halos of " << this->interval * std::max(this->upstream_radius, this->downstream_radius)
+                << " sites are wider than the " << min_size << " sites of a process!" << std::endl;
+        throw std::exception();
+    }
+
+    // All the processes key their random numbers with the seed of the first process
+    unsigned long long seed = (static_cast<unsigned long long>(std::rand()) << 32) ^ std::rand();
+    MPI_Bcast(&seed, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+    this->seed = seed;
+
+    // Allocate the cell arrays of the extended segment of the Lanes, with all sites initially empty
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->speeds.emplace_back(this->extended_size, -1);
+        this->ids.emplace_back(this->extended_size, -1);
+        this->entry_times.emplace_back(this->extended_size, 0);
+        this->intents.emplace_back(this->extended_size, -1);
+    }
+    this->steps_to_spawn.resize(this->num_lanes, 0);
+
+    this->demand = new Demand(inputs);
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->steps_to_spawn[i] = this->demand->getInitialStepsToSpawn(i);
+    }
+}
+
+/**
+ * Destructor of the HaloEngine
+ */
+HaloEngine::~HaloEngine() {
+    delete this->demand;
+}
+
+/**
+ * Draws the uniform random number in [0, 1) of a Vehicle for a time step, which is the same on all the processes. It
+ * is keyed by the id and age of the Vehicle when the simulation has a seed, and by the time, the site and the Lane
+ * otherwise.
+ * @param time the simulation time at the start of the step
+ * @param lane the number of the Lane of the Vehicle
+ * @param site the site of the extended segment of the Lane
+ * @param stream STREAM_SWITCH for the lane switch and STREAM_SLOW_DOWN for the slow down of the lane move
+ * @return the random number
+ */
+double HaloEngine::drawKeyed(const int time, const int lane, const int site, const int stream) const {
+    if (this->random.isEnabled()) {
+        return this->random.draw(this->ids[lane][site], time - this->entry_times[lane][site], stream);
+    }
+    const int road_site = this->offset - this->upstream_width + site;
+    uint64_t x = KeyedRandom::mix(this->seed ^ static_cast<uint64_t>(time));
+    x = KeyedRandom::mix(x ^ static_cast<uint64_t>(road_site));
+    x = KeyedRandom::mix(x ^ static_cast<uint64_t>(2 * lane + stream));
+    return static_cast<double>(x >> 11) / static_cast<double>(uint64_t{1} << 53);
+}
+
+/**
+ * Decides whether the Vehicle in an occupied site switches Lane, based on the configuration before the lane switches,
+ * in the same way as the SweepEngine class, and records the Lane it switches to
+ * @param lane the number of the Lane
+ * @param site the site of the extended segment of the Lane
+ * @param time the simulation time at the start of the step
+ * @param ahead_sites the nearest occupied site downstream of the site in each Lane, -1 if there is none
+ * @param below_sites the last located occupied site upstream of a site in each Lane, relocated when stale
+ */
+void HaloEngine::decide(const int lane, const int site, const int time, const int *ahead_sites, int *below_sites) {
+    const int speed = this->speeds[lane][site];
+
+    // Gap to the preceding Vehicle in the Lane, the Road length minus one if there is none
+    const int look = speed + 1;
+    const int gap_forward = ahead_sites[lane] < 0 ? this->length - 1 : ahead_sites[lane] - site - 1;
+    const bool blocked = gap_forward < look;
+
+    int target = -1;
+    for (int side = SIDE_LEFT; side >= SIDE_RIGHT && target < 0; side--) {
+        const int other = side == SIDE_LEFT ? lane + 1 : lane - 1;
+        if (other < 0 || other >= this->num_lanes || this->speeds[other][site] >= 0) {
+            continue;
+        }
+        if (!blocked && !(this->passing_rule == PASSING_ASYMMETRIC && side == SIDE_RIGHT)) {
+            continue;
+        }
+
+        // Forward gap in the other Lane, whose site next to the Vehicle is known to be empty
+        const int gap_other_forward = ahead_sites[other] < 0 ? this->length - 1 : ahead_sites[other] - site - 1;
+        if (gap_other_forward <= look) {
+            continue;
+        }
+
+        // Backward gap in the other Lane, locating the nearest occupied site behind only when the tracked one is stale
+        int &behind = below_sites[other];
+        if (behind >= site) {
+            behind = site - 1;
+            while (behind >= 0 && this->speeds[other][behind] < 0) {
+                behind--;
+            }
+        }
+        const int gap_other_backward = behind < 0 ? this->length - 1 : site - behind - 1;
+        if (gap_other_backward <= this->look_other_backward) {
+            continue;
+        }
+
+        target = other;
+    }
+
+    if (target >= 0 && this->drawKeyed(time, lane, site, STREAM_SWITCH) <= this->prob_change) {
+        this->intents[lane][site] = static_cast<int8_t>(target);
+    }
+}
+
+/**
+ * Commits the lane switch decided for the Vehicle in a site, the Vehicle switching from the lower numbered Lane having
+ * priority when two Vehicles target the same site
+ * @param lane the number of the Lane
+ * @param site the site of the extended segment of the Lane
+ */
+void HaloEngine::commit(const int lane, const int site) {
+    const int target = this->intents[lane][site];
+    if (target < lane && target > 0 && this->intents[target - 1][site] == target) {
+        return;
+    }
+
+    this->speeds[target][site] = this->speeds[lane][site];
+    this->ids[target][site] = this->ids[lane][site];
+    this->entry_times[target][site] = this->entry_times[lane][site];
+    this->speeds[lane][site] = -1;
+}
+
+/**
+ * Moves the Vehicle in an occupied site of a Lane according to its speed, after all the Vehicles downstream of it have
+ * moved. The Vehicles moving past the end of the extended segment leave the Road on the last process, and are dropped
+ * from the downstream halo on the others.
+ * @param lane the number of the Lane
+ * @param site the site of the extended segment of the Lane
+ * @param time the simulation time at the start of the step
+ * @param next_moved_sites the site of the last moved Vehicle before its move in each Lane, -1 if there is none
+ * @param travel_times pointer to the list to append the travel times (in steps) of the Vehicles leaving the Road to
+ */
+void HaloEngine::move(const int lane, const int site, const int time, int *next_moved_sites,
+                      std::vector<int> *travel_times) {
+    int speed = this->speeds[lane][site];
+
+    // Gap to the position of the preceding Vehicle before it moved
+    const int gap_forward = next_moved_sites[lane] < 0 ? this->length - 1 : next_moved_sites[lane] - site - 1;
+    next_moved_sites[lane] = site;
+
+    // Update Vehicle speed based on vehicle speed update rules
+    if (speed != this->max_speed) {
+        speed++;
+    }
+    speed = std::min(speed, gap_forward);
+    if (speed > 0 && this->drawKeyed(time, lane, site, STREAM_SLOW_DOWN) <= this->prob_slow_down) {
+        speed--;
+    }
+
+    if (speed == 0) {
+        this->speeds[lane][site] = 0;
+        return;
+    }
+
+    const int new_site = site + speed;
+    this->speeds[lane][site] = -1;
+    if (new_site >= this->extended_size) {
+        if (this->ownsRoadEnd()) {
+            travel_times->push_back(time + 1 - this->entry_times[lane][site]);
+        }
+        return;
+    }
+
+    this->speeds[lane][new_site] = static_cast<int8_t>(speed);
+    this->ids[lane][new_site] = this->ids[lane][site];
+    this->entry_times[lane][new_site] = this->entry_times[lane][site];
+}
+
+/**
+ * Performs the lane switches and lane moves of a time step on the whole extended segment of the Lanes, in three passes:
+ * the decisions of all the sites, the commits of the switches, and the moves, which also clear the decisions
+ * @param time the simulation time at the start of the step
+ * @param travel_times pointer to the list to append the travel times (in steps) of the Vehicles leaving the Road to
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::step(const int time, std::vector<int> *travel_times) {
+    const double begin = MPI_Wtime();
+    std::vector<int> ahead_sites(this->num_lanes);
+    std::vector<int> below_sites(this->num_lanes);
+
+    for (int i = 0; i < this->num_lanes; i++) {
+        std::fill(ahead_sites.begin(), ahead_sites.end(), -1);
+        std::fill(below_sites.begin(), below_sites.end(), this->extended_size);
+        for (int site = this->extended_size - 1; site >= 0; site--) {
+            if (this->speeds[i][site] >= 0) {
+                this->decide(i, site, time, ahead_sites.data(), below_sites.data());
+            }
+            for (int lane = std::max(0, i - 1); lane <= std::min(this->num_lanes - 1, i + 1); lane++) {
+                if (this->speeds[lane][site] >= 0) {
+                    ahead_sites[lane] = site;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < this->num_lanes; i++) {
+        for (int site = this->extended_size - 1; site >= 0; site--) {
+            if (this->intents[i][site] >= 0) {
+                this->commit(i, site);
+            }
+        }
+    }
+
+    std::vector<int> next_moved_sites(this->num_lanes, -1);
+    for (int i = 0; i < this->num_lanes; i++) {
+        for (int site = this->extended_size - 1; site >= 0; site--) {
+            this->intents[i][site] = -1;
+            if (this->speeds[i][site] >= 0) {
+                this->move(i, site, time, next_moved_sites.data(), travel_times);
+            }
+        }
+    }
+    this->step_time += MPI_Wtime() - begin;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Attempts to spawn a Vehicle at the first site of each Lane on the first process, in the same way as the Lane class
+ * @param time the simulation time, recorded as the entry time of the spawned Vehicles
+ * @param next_id_ptr pointer to the id number of the next spawned Vehicle
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::attemptSpawn(const int time, int *next_id_ptr) {
+    if (this->rank != 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < this->num_lanes; i++) {
+        if (this->steps_to_spawn[i] == 0) {
+            if (this->speeds[i][0] < 0) {
+                this->speeds[i][0] = static_cast<int8_t>(this->max_speed);
+                this->ids[i][0] = (*next_id_ptr)++;
+                this->entry_times[i][0] = time;
+
+                // Randomly choose the Vehicles initial speed to be zero bases in slow down probability
+                const double u = this->random.isEnabled()
+                                     ? this->random.draw(this->ids[i][0], 0, STREAM_SPAWN_SPEED)
+                                     : static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+                if (u < this->prob_slow_down) {
+                    this->speeds[i][0] = 0;
+                }
+
+                // "Schedule" next Vehicle spawn
+                this->steps_to_spawn[i] = this->demand->drawStepsToSpawn(i, time);
+            }
+        } else {
+            this->steps_to_spawn[i]--;
+        }
+    }
+
+    // Return with no error
+    return 0;
+}
+
+/**
+ * Sends the cells of a range of sites of all the Lanes to one neighbour process and receives the cells of a range of
+ * sites from the other one, either of which may be MPI_PROC_NULL at the ends of the Road
+ * @param destination the rank of the process to send to
+ * @param source the rank of the process to receive from
+ * @param send_site the first site of the extended segment to send
+ * @param receive_site the first site of the extended segment to receive
+ * @param width the number of sites sent and received
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::shiftHalo(const int destination, const int source, const int send_site, const int receive_site,
+                          const int width) {
+    // Pack the speed, id and entry time of each site of each Lane
+    const int count = 3 * this->num_lanes * width;
+    std::vector<int> send_buffer;
+    std::vector<int> receive_buffer(count);
+    if (destination != MPI_PROC_NULL) {
+        send_buffer.reserve(count);
+        for (int i = 0; i < this->num_lanes; i++) {
+            for (int site = send_site; site < send_site + width; site++) {
+                send_buffer.push_back(this->speeds[i][site]);
+                send_buffer.push_back(this->ids[i][site]);
+                send_buffer.push_back(this->entry_times[i][site]);
+            }
+        }
+    }
+
+    if (const int status = MPI_Sendrecv(send_buffer.data(), destination != MPI_PROC_NULL ? count : 0, MPI_INT,
+                                        destination, 0, receive_buffer.data(), source != MPI_PROC_NULL ? count : 0,
+                                        MPI_INT, source, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); status != MPI_SUCCESS) {
+        return status;
+    }
+
+    // Unpack the received halo
+    if (source != MPI_PROC_NULL) {
+        int n = 0;
+        for (int i = 0; i < this->num_lanes; i++) {
+            for (int site = receive_site; site < receive_site + width; site++) {
+                this->speeds[i][site] = static_cast<int8_t>(receive_buffer[n++]);
+                this->ids[i][site] = receive_buffer[n++];
+                this->entry_times[i][site] = receive_buffer[n++];
+            }
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Exchanges the halos with the neighbour processes once every interval steps, replacing the redundantly computed
+ * cells of the halos with the cells computed by their owners
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::exchangeHalos() {
+    if (++this->steps_since_exchange < this->interval) {
+        return 0;
+    }
+    this->steps_since_exchange = 0;
+
+    const double begin = MPI_Wtime();
+    const int upstream = this->rank > 0 ? this->rank - 1 : MPI_PROC_NULL;
+    const int downstream = this->rank < this->num_processes - 1 ? this->rank + 1 : MPI_PROC_NULL;
+    const int upstream_halo_width = this->interval * this->upstream_radius;
+    const int downstream_halo_width = this->interval * this->downstream_radius;
+
+    // The end of the owned segment is the upstream halo of the downstream neighbour, and the start of the owned segment
+    // the downstream halo of the upstream neighbour
+    if (const int status = this->shiftHalo(downstream, upstream, this->upstream_width + this->size -
+                                           upstream_halo_width, 0, upstream_halo_width); status != 0) {
+        return status;
+    }
+    if (const int status = this->shiftHalo(upstream, downstream, this->upstream_width,
+                                           this->upstream_width + this->size, downstream_halo_width); status != 0) {
+        return status;
+    }
+
+    this->num_exchanges++;
+    this->exchange_time += MPI_Wtime() - begin;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Moves the cells of the owned segments to the processes that own them or have them in their halos after the
+ * boundaries of the segments move, and allocates the new extended segment of the process
+ * @param new_offsets the new first site of the segment of each process
+ * @param new_sizes the new number of sites of the segment of each process
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::migrateCells(const std::vector<int> &new_offsets, const std::vector<int> &new_sizes) {
+    // Gather the current segments of all the processes
+    std::vector<int> offsets(this->num_processes);
+    std::vector<int> sizes(this->num_processes);
+    MPI_Allgather(&this->offset, 1, MPI_INT, offsets.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    MPI_Allgather(&this->size, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    // The new extended segment of a process, whose halo widths only depend on its rank
+    const auto extended_begin = [&](const int q) {
+        return new_offsets[q] - (q > 0 ? this->interval * this->upstream_radius : 0);
+    };
+    const auto extended_end = [&](const int q) {
+        return new_offsets[q] + new_sizes[q] + (q < this->num_processes - 1
+                                                    ? this->interval * this->downstream_radius
+                                                    : 0);
+    };
+
+    // Pack the speed, id and entry time of each site of each Lane of the owned segment that each process needs
+    const int values_per_site = 3 * this->num_lanes;
+    std::vector<int> send_counts(this->num_processes, 0);
+    std::vector<int> send_displacements(this->num_processes, 0);
+    std::vector<int> send_buffer;
+    for (int q = 0; q < this->num_processes; q++) {
+        send_displacements[q] = static_cast<int>(send_buffer.size());
+        const int begin = std::max(this->offset, extended_begin(q));
+        const int end = std::min(this->offset + this->size, extended_end(q));
+        for (int road_site = begin; road_site < end; road_site++) {
+            const int site = road_site - this->offset + this->upstream_width;
+            for (int i = 0; i < this->num_lanes; i++) {
+                send_buffer.push_back(this->speeds[i][site]);
+                send_buffer.push_back(this->ids[i][site]);
+                send_buffer.push_back(this->entry_times[i][site]);
+            }
+        }
+        send_counts[q] = static_cast<int>(send_buffer.size()) - send_displacements[q];
+    }
+
+    // Receive the cells of the new extended segment from their current owners
+    std::vector<int> receive_counts(this->num_processes, 0);
+    std::vector<int> receive_displacements(this->num_processes, 0);
+    int receive_size = 0;
+    for (int q = 0; q < this->num_processes; q++) {
+        const int begin = std::max(offsets[q], extended_begin(this->rank));
+        const int end = std::min(offsets[q] + sizes[q], extended_end(this->rank));
+        receive_displacements[q] = receive_size;
+        receive_counts[q] = std::max(0, end - begin) * values_per_site;
+        receive_size += receive_counts[q];
+    }
+    std::vector<int> receive_buffer(receive_size);
+    if (const int status = MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displacements.data(), MPI_INT,
+                                         receive_buffer.data(), receive_counts.data(), receive_displacements.data(),
+                                         MPI_INT, MPI_COMM_WORLD); status != MPI_SUCCESS) {
+        return status;
+    }
+
+    // The segments cover the Road in order, so the received cells are the new extended segment in order
+    this->offset = new_offsets[this->rank];
+    this->size = new_sizes[this->rank];
+    this->extended_size = this->upstream_width + this->size + this->downstream_width;
+    int n = 0;
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->speeds[i].assign(this->extended_size, -1);
+        this->ids[i].assign(this->extended_size, -1);
+        this->entry_times[i].assign(this->extended_size, 0);
+        this->intents[i].assign(this->extended_size, -1);
+    }
+    for (int site = 0; site < this->extended_size; site++) {
+        for (int i = 0; i < this->num_lanes; i++) {
+            this->speeds[i][site] = static_cast<int8_t>(receive_buffer[n++]);
+            this->ids[i][site] = receive_buffer[n++];
+            this->entry_times[i][site] = receive_buffer[n++];
+        }
+    }
+    this->steps_since_exchange = 0;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Rebalances the segments of the processes once every rebalance interval steps if the time the processes spent
+ * computing their steps since the last check is unbalanced by more than the threshold. The new boundaries give each
+ * process an equal share of the cost, assumed uniform over the sites of each current segment, with at least the halo
+ * width of sites.
+ * @param time the simulation time
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::rebalance(const int time) {
+    if (this->rebalance_interval <= 0 || this->num_processes == 1 ||
+        ++this->steps_since_rebalance < this->rebalance_interval) {
+        return 0;
+    }
+    this->steps_since_rebalance = 0;
+
+    // Gather the step costs and segments of all the processes
+    std::vector<double> costs(this->num_processes);
+    std::vector<int> offsets(this->num_processes);
+    std::vector<int> sizes(this->num_processes);
+    MPI_Allgather(&this->step_time, 1, MPI_DOUBLE, costs.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+    MPI_Allgather(&this->offset, 1, MPI_INT, offsets.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    MPI_Allgather(&this->size, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    this->step_time = 0.0;
+
+    double total_cost = 0.0;
+    double max_cost = 0.0;
+    for (const double cost: costs) {
+        total_cost += cost;
+        max_cost = std::max(max_cost, cost);
+    }
+    if (total_cost <= 0.0) {
+        return 0;
+    }
+    this->imbalance = max_cost / (total_cost / this->num_processes) - 1.0;
+    if (this->imbalance <= this->rebalance_threshold) {
+        return 0;
+    }
+
+    // Place each boundary where the cumulative cost reaches its share, keeping room for the halos on both sides
+    const int min_size = this->interval * std::max(this->upstream_radius, this->downstream_radius);
+    std::vector<int> new_offsets(this->num_processes, 0);
+    int q = 0;
+    double cumulative_cost = 0.0;
+    for (int r = 1; r < this->num_processes; r++) {
+        const double target = total_cost * r / this->num_processes;
+        while (q < this->num_processes - 1 && cumulative_cost + costs[q] < target) {
+            cumulative_cost += costs[q];
+            q++;
+        }
+        const double fraction = costs[q] > 0.0 ? (target - cumulative_cost) / costs[q] : 0.0;
+        const int boundary = offsets[q] + static_cast<int>(fraction * sizes[q] + 0.5);
+        new_offsets[r] = std::min(std::max(boundary, new_offsets[r - 1] + min_size),
+                                  this->length - (this->num_processes - r) * min_size);
+    }
+    std::vector<int> new_sizes(this->num_processes);
+    for (int r = 0; r < this->num_processes; r++) {
+        new_sizes[r] = (r < this->num_processes - 1 ? new_offsets[r + 1] : this->length) - new_offsets[r];
+    }
+
+    if (this->rank == 0) {
+        std::ostringstream sizes_stream;
+        for (int r = 0; r < this->num_processes; r++) {
+            sizes_stream << " " << sizes[r] << "->" << new_sizes[r];
+        }
+        std::cout << "rebalancing at time " << time << ": imbalance " << 100.0 * this->imbalance << "% > "
+                << 100.0 * this->rebalance_threshold << "%, sites per process" << sizes_stream.str() << std::endl;
+    }
+
+    this->num_rebalances++;
+    return this->migrateCells(new_offsets, new_sizes);
+}
+
+/**
+ * Getter for the first site of the Road owned by the process
+ * @return the offset of the segment of the process
+ */
+int HaloEngine::getOffset() const {
+    return this->offset;
+}
+
+/**
+ * Getter for a read-only view of the speeds of the sites of a Lane owned by the process, without its halos, -1 for the
+ * empty sites. The view is valid until the next step, and until the next rebalancing moves the segment
+ * @param lane the number of the Lane
+ * @return the speeds of the sites of the segment of the Lane
+ */
+Span<int8_t> HaloEngine::getLaneSpeeds(const int lane) const {
+    return {this->speeds[lane].data() + this->upstream_width, static_cast<size_t>(this->size)};
+}
+
+/**
+ * Checks whether the process owns the end of the Road, where the Vehicles leave it
+ * @return whether the process is the last one
+ */
+bool HaloEngine::ownsRoadEnd() const {
+    return this->rank == this->num_processes - 1;
+}
+
+/**
+ * Shares the decision to stop the simulation of the last process, the only one measuring the travel times, with all
+ * the processes, so that they stop at the same step
+ * @param stop whether the last process stops, ignored on the other processes
+ * @return whether all the processes stop
+ */
+bool HaloEngine::shareStop(const bool stop) const {
+    int flag = stop ? 1 : 0;
+    MPI_Bcast(&flag, 1, MPI_INT, this->num_processes - 1, MPI_COMM_WORLD);
+    return flag != 0;
+}
+
+/**
+ * Prints the tradeoff of the halo exchanges of the process: the time saved by exchanging less often against the
+ * redundant updates of the halo sites
+ * @param time_elapsed the total computation time of the simulation
+ * @param num_steps the number of steps of the simulation
+ * @return 0 if successful, nonzero otherwise
+ */
+int HaloEngine::printExchangeSummary(const double time_elapsed, const int num_steps) const {
+    std::cout << "halo exchange (process " << this->rank << "): interval=" << this->interval << " steps, halo widths="
+            << this->upstream_width << "/" << this->downstream_width << " sites, exchanges=" << this->num_exchanges
+            << ", exchange time=" << this->exchange_time << " [s] (" << 100.0 * this->exchange_time / time_elapsed
+            << "%), average exchange time=" << (this->num_exchanges > 0 ? this->exchange_time / this->num_exchanges : 0)
+            << " [s], redundant site updates="
+            << 100.0 * (this->extended_size - this->size) / this->size << "% of " << this->size << " owned sites over "
+            << num_steps << " steps" << std::endl;
+    if (this->rebalance_interval > 0) {
+        std::cout << "rebalancing (process " << this->rank << "): rebalances=" << this->num_rebalances
+                << ", last measured imbalance=" << 100.0 * this->imbalance << "%, sites=" << this->size << std::endl;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Debug function to print the owned segment of the Lanes to visualize the sites
+ */
+#ifdef DEBUG
+void HaloEngine::printLanes() const {
+    for (int i = this->num_lanes - 1; i >= 0; i--) {
+        std::ostringstream lane_string_stream;
+        for (int j = this->upstream_width; j < this->upstream_width + this->size; j++) {
+            if (this->speeds[i][j] < 0) {
+                lane_string_stream << "[   ]";
+            } else {
+                lane_string_stream << "[" << std::setw(3) << this->ids[i][j] << "]";
+            }
+        }
+        std::cout << lane_string_stream.str() << std::endl;
+    }
+}
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_HALOENGINE_H
+#define CA_TRAFFIC_SIMULATION_HALOENGINE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Inputs.h"
+#include "Demand.h"
+#include "KeyedRandom.h"
+#include "ProcessData.h"
+#include "Span.h"
+
+/**
+ * Class for the halo exchange step engine, which simulates the open road distributed over the MPI processes, each
+ * process owning a segment of the sites of all the Lanes like the Lane class. The cells of a time step of a site only
+ * depend on the cells within a bounded distance of it at the previous step: upstream_radius sites upstream (a Vehicle
+ * moving in from max_speed sites behind after switching Lane, which looks look_other_backward + 1 sites behind it) and
+ * downstream_radius sites downstream (a Vehicle braking to the Vehicles that switched in up to max_speed sites ahead,
+ * which looked max_speed + 1 sites ahead of them).
+ *
+ * Each process stores its segment with halos of the neighbouring segments, interval times the radii wide, and exchanges
+ * them with its neighbours only every interval steps. In between, it updates the whole extended segment, so that the
+ * cells of the halos are recomputed redundantly and the invalid cells at the ends of the extended segment spread inwards
+ * by the radii each step, never reaching the owned segment. The random numbers of a Vehicle are keyed by the time, the
+ * site and the Lane instead of drawn in sequence, so that all the processes that update a site draw the same ones, and
+ * the simulation does not depend on the number of processes or the interval. With a seed they are keyed by the id and
+ * age of the Vehicle instead, like in the other engines.
+ *
+ * The Vehicles are spawned at the start of the Road by the first process, and leave it at the end on the last process.
+ *
+ * The work of a process grows with the number of its Vehicles, so jams make the processes unbalanced. Every
+ * rebalance_interval steps the processes compare the time they spent computing their steps, and if the slowest one is
+ * more than rebalance_threshold above the average, the boundaries of the segments are moved so that each process gets
+ * an equal share of the measured cost, spread uniformly over the sites of each segment, and the cells are migrated to
+ * their new owners.
+ */
+class HaloEngine {
+    int num_lanes;
+    int length;
+    int max_speed;
+    int look_other_backward;
+    int passing_rule;
+    double prob_slow_down;
+    double prob_change;
+    int rank;
+    int num_processes;
+    int offset;
+    int size;
+    int interval;
+    int upstream_radius;
+    int downstream_radius;
+    int upstream_width;
+    int downstream_width;
+    int extended_size;
+    int steps_since_exchange;
+    uint64_t seed;
+    KeyedRandom random;
+    std::vector<std::vector<int8_t> > speeds;
+    std::vector<std::vector<int> > ids;
+    std::vector<std::vector<int> > entry_times;
+    std::vector<std::vector<int8_t> > intents;
+    std::vector<int> steps_to_spawn;
+    Demand *demand;
+    int num_exchanges;
+    double exchange_time;
+    int rebalance_interval;
+    double rebalance_threshold;
+    int steps_since_rebalance;
+    double step_time;
+    int num_rebalances;
+    double imbalance;
+
+    [[nodiscard]] double drawKeyed(int time, int lane, int site, int stream) const;
+
+    void decide(int lane, int site, int time, const int *ahead_sites, int *below_sites);
+
+    void commit(int lane, int site);
+
+    void move(int lane, int site, int time, int *next_moved_sites, std::vector<int> *travel_times);
+
+    int shiftHalo(int destination, int source, int send_site, int receive_site, int width);
+
+    int migrateCells(const std::vector<int> &new_offsets, const std::vector<int> &new_sizes);
+
+public:
+    HaloEngine(const Inputs &inputs, const ProcessData &process_data);
+
+    ~HaloEngine();
+
+    int step(int time, std::vector<int> *travel_times);
+
+    int attemptSpawn(int time, int *next_id_ptr);
+
+    int exchangeHalos();
+
+    int rebalance(int time);
+
+    [[nodiscard]] bool ownsRoadEnd() const;
+
+    [[nodiscard]] bool shareStop(bool stop) const;
+
+    [[nodiscard]] int getOffset() const;
+
+    [[nodiscard]] Span<int8_t> getLaneSpeeds(int lane) const;
+
+    int printExchangeSummary(double time_elapsed, int num_steps) const;
+
+#ifdef DEBUG
+    void printLanes() const;
+#endif
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_HALOENGINE_H
@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
 #include "Inputs.h"
@@ -17,18 +18,33 @@ std::string parseLine(const std::string &line) {
     return line.substr(0, line.find(' '));
 }
 
+/**
+ * Helper function to parse an optional line in the input file, which may be left out at the end of the file
+ * @param input_lines the lines of the input file
+ * @param n pointer to the index of the line to parse, which is advanced if the line exists
+ * @param default_value the parameter to use if the input file has no such line
+ * @return the parameter on the line, or the default parameter
+ */
+std::string parseOptionalLine(const std::vector<std::string> &input_lines, int *n, const std::string &default_value) {
+    if ((*n) >= static_cast<int>(input_lines.size()) || parseLine(input_lines[*n]).empty()) {
+        return default_value;
+    }
+    return parseLine(input_lines[(*n)++]);
+}
+
 /**
  * Loads the inputs options from a text file into the class variables
+ * @param file_name path and name of the input file
  * @return 0 if successful, nonzero otherwise
  */
-int Inputs::loadFromFile() {
+int Inputs::loadFromFile(const std::string &file_name) {
     // Open the input file for reading the simulation inputs
     std::fstream input_file;
-    input_file.open("cats-input.txt", std::fstream::in);
+    input_file.open(file_name, std::fstream::in);
 
     // Check of the input file was loaded properly
     if (!input_file) {
-        std::cout << "error: failure to open \"cats-input.txt\" file!" << std::endl;
+        std::cout << "error: failure to open \"" << file_name << "\" file!" << std::endl;
         return 1;
     }
 
@@ -39,6 +55,17 @@ int Inputs::loadFromFile() {
         input_lines.push_back(line);
     }
 
+    // Close the input file
+    input_file.close();
+    return this->loadFromLines(input_lines);
+}
+
+/**
+ * Loads the inputs options from the lines of an input file into the class variables
+ * @param input_lines the lines of the input file
+ * @return 0 if successful, nonzero otherwise
+ */
+int Inputs::loadFromLines(const std::vector<std::string> &input_lines) {
     // Parse each line of the input file into the variable it corresponds to
     int n = 0;
     this->num_lanes = std::stoi(parseLine(input_lines[n++]));
@@ -53,8 +80,237 @@ int Inputs::loadFromFile() {
     this->step_size = std::stod(parseLine(input_lines[n++]));
     this->warmup_time = std::stoi(parseLine(input_lines[n++]));
 
-    // Close the input file
-    input_file.close();
+    // Parse the optional lines of the input file
+    this->engine = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->traversal_order = std::stoi(parseOptionalLine(input_lines, &n, "1"));
+    this->passing_rule = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->num_threads = std::stoi(parseOptionalLine(input_lines, &n, "1"));
+    this->kernel = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->boundary = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->percent_full = std::stod(parseOptionalLine(input_lines, &n, "0.0"));
+    this->halo_interval = std::stoi(parseOptionalLine(input_lines, &n, "1"));
+    this->rebalance_interval = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->rebalance_threshold = std::stod(parseOptionalLine(input_lines, &n, "0.1"));
+    this->demand = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->demand_start_time = std::stod(parseOptionalLine(input_lines, &n, "0.0"));
+    this->target_precision = std::stod(parseOptionalLine(input_lines, &n, "0.0"));
+    this->precision_check_interval = std::stoi(parseOptionalLine(input_lines, &n, "100"));
+    this->seed = std::stoull(parseOptionalLine(input_lines, &n, "0"));
+    this->num_replicas = std::stoi(parseOptionalLine(input_lines, &n, "1"));
+    this->antithetic = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->paired_scenario = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->feed_interval = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->feed_bins = std::stoi(parseOptionalLine(input_lines, &n, "80"));
+    this->huge_pages = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    if (std::stoi(parseOptionalLine(input_lines, &n, "0")) != 0) {
+        if (const int status = this->loadVehicleClasses("vehicle-classes.dat"); status != 0) {
+            return status;
+        }
+    }
+    this->macro_density = std::stod(parseOptionalLine(input_lines, &n, "0.0"));
+    this->golden_reference = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->tune_steps = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+    this->snapshot_interval = std::stoi(parseOptionalLine(input_lines, &n, "0"));
+#ifdef DEBUG
+    // Lock the number of threads to one in debug mode
+    this->num_threads = 1;
+#endif
+
+    // Check the combination of the inputs
+    return this->validate();
+}
+
+/**
+ * Loads the Vehicle classes from a text file, one per line as "name,length,max_speed,prob_slow_down,prob_change,share"
+ * @param file_name path and name of the file of the Vehicle classes
+ * @return 0 if successful, nonzero otherwise
+ */
+int Inputs::loadVehicleClasses(const std::string &file_name) {
+    std::ifstream file(file_name);
+    if (!file) {
+        std::cout << "error: failure to open \"" << file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    this->vehicle_classes.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream line_stream(line);
+        std::string field;
+        while (std::getline(line_stream, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 6) {
+            std::cout << "error: the vehicle class \"" << line << "\" needs a name, length, maximum speed, slow down "
+                    << "and lane change probabilities, and a share!" << std::endl;
+            return 1;
+        }
+        this->vehicle_classes.push_back({
+            fields[0], std::stoi(fields[1]), std::stoi(fields[2]), std::stod(fields[3]), std::stod(fields[4]),
+            std::stod(fields[5])
+        });
+    }
+    if (this->vehicle_classes.empty()) {
+        std::cout << "error: \"" << file_name << "\" has no vehicle classes!" << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Checks that the inputs are a combination of options the simulation supports, whether they were loaded from a file or
+ * set directly in memory
+ * @return 0 if valid, nonzero otherwise
+ */
+int Inputs::validate() const {
+    // The speeds of the sites are stored or reported as int8_t by all the engines but the multi-spin and network ones
+    if (this->max_speed > MAX_SITE_SPEED && this->engine != ENGINE_MULTI_SPIN && this->engine != ENGINE_NETWORK) {
+        std::cout << "error: the maximum speed must not exceed " << MAX_SITE_SPEED << " sites per step!" << std::endl;
+        return 1;
+    }
+
+    // The multi-spin engine only simulates the ring road
+    if (this->engine == ENGINE_MULTI_SPIN && this->boundary != BOUNDARY_PERIODIC) {
+        std::cout << "error: the multi-spin engine requires the ring road boundary condition!" << std::endl;
+        return 1;
+    }
+
+    // The halo exchange engine only simulates the open road, exchanging its halos at least every step
+    if (this->engine == ENGINE_HALO && this->boundary != BOUNDARY_OPEN) {
+        std::cout << "error: the halo exchange engine requires the open road boundary condition!" << std::endl;
+        return 1;
+    }
+    // The road network engine only simulates open road segments, which the Vehicles enter and leave through the links
+    if (this->engine == ENGINE_NETWORK && this->boundary != BOUNDARY_OPEN) {
+        std::cout << "error: the road network engine requires the open road boundary condition!" << std::endl;
+        return 1;
+    }
+    if (this->halo_interval < 1) {
+        std::cout << "error: the halo exchange interval must be at least one step!" << std::endl;
+        return 1;
+    }
+
+    // The ring road is initially filled with a fraction of its sites
+    if (this->percent_full < 0.0 || this->percent_full > 1.0) {
+        std::cout << "error: the fraction of the sites initially occupied must be between 0 and 1!" << std::endl;
+        return 1;
+    }
+
+    // The road network segments switch to the macroscopic model below a density of Vehicles per site
+    if (this->macro_density < 0.0 || this->macro_density > 1.0) {
+        std::cout << "error: the macroscopic density must be between 0 and 1 vehicles per site!" << std::endl;
+        return 1;
+    }
+    if (this->macro_density > 0.0 && this->engine != ENGINE_NETWORK) {
+        std::cout << "error: the macroscopic model requires the road network engine!" << std::endl;
+        return 1;
+    }
+
+    // The golden reference check is on or off
+    if (this->golden_reference != 0 && this->golden_reference != 1) {
+        std::cout << "error: the golden reference check must be 0 or 1!" << std::endl;
+        return 1;
+    }
+
+    // The auto-tuner benchmarks each configuration for a number of steps
+    if (this->tune_steps < 0) {
+        std::cout << "error: the number of auto-tuning steps must not be negative!" << std::endl;
+        return 1;
+    }
+
+    // The demand is one of its sources
+    if (this->demand < DEMAND_STATIONARY || this->demand > DEMAND_TRACE) {
+        std::cout << "error: unknown demand source " << this->demand << "!" << std::endl;
+        return 1;
+    }
+
+    // The multi-spin engine only measures its replicas at the end of the run, so it cannot stop on the precision
+    if (this->target_precision > 0.0 && this->engine == ENGINE_MULTI_SPIN) {
+        std::cout << "error: the multi-spin engine does not support stopping at a target precision!" << std::endl;
+        return 1;
+    }
+    if (this->precision_check_interval < 1) {
+        std::cout << "error: the precision check interval must be at least one step!" << std::endl;
+        return 1;
+    }
+
+    // The replicas come in antithetic pairs, and both the antithetic and the paired scenarios share keyed random numbers
+    if (this->num_replicas < 1) {
+        std::cout << "error: the number of replicas must be at least one!" << std::endl;
+        return 1;
+    }
+    if (this->antithetic != 0 && (this->seed == 0 || this->num_replicas % 2 != 0 ||
+                                  this->engine == ENGINE_MULTI_SPIN)) {
+        std::cout << "error: antithetic replicas require a seed, an even number of replicas and a single replica engine!"
+                << std::endl;
+        return 1;
+    }
+    if (this->paired_scenario != 0 && this->seed == 0) {
+        std::cout << "error: the paired scenario requires a seed to share its random numbers!" << std::endl;
+        return 1;
+    }
+
+    // The live feed is published every so many steps, with at least one bin per Lane
+    if (this->feed_interval < 0 || this->feed_bins < 1) {
+        std::cout << "error: the live feed interval must not be negative and the feed needs at least one bin!"
+                << std::endl;
+        return 1;
+    }
+
+    // The snapshots are written every so many steps, from the engines that have a view of the sites of their Lanes
+    if (this->snapshot_interval < 0) {
+        std::cout << "error: the snapshot interval must not be negative!" << std::endl;
+        return 1;
+    }
+    if (this->snapshot_interval > 0 && (this->engine == ENGINE_MULTI_SPIN || this->engine == ENGINE_NETWORK)) {
+        std::cout << "error: the snapshots require the reference, fused lane sweep or halo exchange engine!"
+                << std::endl;
+        return 1;
+    }
+
+    // The huge pages are one of their kinds
+    if (this->huge_pages < HUGE_PAGES_NONE || this->huge_pages > HUGE_PAGES_EXPLICIT) {
+        std::cout << "error: unknown huge pages " << this->huge_pages << "!" << std::endl;
+        return 1;
+    }
+
+    // The in-memory CDF of the interarrival times has a cumulative probability for each interarrival time
+    if (this->interarrival_times.size() != this->interarrival_probabilities.size()) {
+        std::cout << "error: the in-memory interarrival CDF needs one cumulative probability per interarrival time!"
+                << std::endl;
+        return 1;
+    }
+
+    // The Vehicle classes are only simulated by the reference engine, whose Vehicles carry their class, on the open
+    // road where the long Vehicles enter and leave through the ends
+    if (!this->vehicle_classes.empty()) {
+        if (this->engine != ENGINE_REFERENCE || this->boundary != BOUNDARY_OPEN) {
+            std::cout << "error: vehicle classes require the reference engine and the open road boundary condition!"
+                    << std::endl;
+            return 1;
+        }
+        double total_share = 0.0;
+        for (const auto &vehicle_class: this->vehicle_classes) {
+            if (vehicle_class.length < 1 || vehicle_class.max_speed < 1 || vehicle_class.max_speed > MAX_SITE_SPEED ||
+                vehicle_class.prob_slow_down < 0.0 || vehicle_class.prob_slow_down > 1.0 ||
+                vehicle_class.prob_change < 0.0 || vehicle_class.prob_change > 1.0 || vehicle_class.share < 0.0) {
+                std::cout << "error: the vehicle class " << vehicle_class.name << " needs a positive length, a "
+                        << "maximum speed from 1 to " << MAX_SITE_SPEED << ", probabilities between 0 and 1 and a "
+                        << "share of at least 0!" << std::endl;
+                return 1;
+            }
+            total_share += vehicle_class.share;
+        }
+        if (total_share <= 0.0) {
+            std::cout << "error: the shares of the vehicle classes must not all be zero!" << std::endl;
+            return 1;
+        }
+    }
 
     // Return with zero errors
     return 0;
@@ -6,16 +6,70 @@
 #define CA_TRAFFIC_SIMULATION_INPUTS_H
 
 #include <iostream>
+#include <string>
+#include <vector>
+
+// Step engines of the simulation
+constexpr int ENGINE_REFERENCE = 0;
+constexpr int ENGINE_SWEEP = 1;
+constexpr int ENGINE_MULTI_SPIN = 2;
+constexpr int ENGINE_HALO = 3;
+constexpr int ENGINE_NETWORK = 4;
+
+// Passing rules for the lane switches
+constexpr int PASSING_SYMMETRIC = 0;
+constexpr int PASSING_ASYMMETRIC = 1;
+
+// Boundary conditions of the Road
+constexpr int BOUNDARY_OPEN = 0;
+constexpr int BOUNDARY_PERIODIC = 1;
+
+// Sources of the demand of Vehicles entering the open road
+constexpr int DEMAND_STATIONARY = 0;
+constexpr int DEMAND_SCHEDULE = 1;
+constexpr int DEMAND_TRACE = 2;
+
+// Huge pages backing the large cell arrays of the Lanes
+constexpr int HUGE_PAGES_NONE = 0;
+constexpr int HUGE_PAGES_TRANSPARENT = 1;
+constexpr int HUGE_PAGES_EXPLICIT = 2;
+
+// Number of sites of the chunks of the Lanes whose Vehicles are counted to skip empty stretches, as a power of two
+constexpr int CHUNK_SHIFT = 6;
+constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+
+// Highest speed the engines that store or report the speeds of the sites as int8_t can hold
+constexpr int MAX_SITE_SPEED = 127;
+
+// Sides of the neighbour Lanes of a Lane, the right one having the lower Lane number
+constexpr int SIDE_RIGHT = 0;
+constexpr int SIDE_LEFT = 1;
+
+/**
+ * Structure for a class of Vehicles, such as cars or trucks, with its own length in sites, maximum speed, slow down and
+ * lane change probabilities, and share of the Vehicles entering the Road
+ */
+struct VehicleClass {
+    std::string name;
+    int length;
+    int max_speed;
+    double prob_slow_down;
+    double prob_change;
+    double share;
+};
 
 /**
  * Class for the input options of a simulation that acts as a structure to organize the inputs in one place.
- * Has methods to load all the inputs from a file from an input text file.
+ * Has methods to load all the inputs from a file from an input text file. The optional inputs default to the values of
+ * their missing lines, and the CDF of the interarrival times, read from "interarrival-cdf.dat" when left empty, may be
+ * given in memory instead. The Vehicle classes are read from "vehicle-classes.dat" when requested or given in memory,
+ * and without classes all the Vehicles follow the speed and probabilities of the inputs.
  */
 class Inputs {
 public:
     int num_lanes;
     int length;
-    double percent_full;
+    double percent_full = 0.0;
     int max_speed;
     int look_forward;
     int look_other_forward;
@@ -25,7 +79,41 @@ public:
     int max_time;
     double step_size;
     int warmup_time;
-    int loadFromFile();
+    int engine = ENGINE_REFERENCE;
+    int traversal_order = 1;
+    int passing_rule = PASSING_SYMMETRIC;
+    int num_threads = 1;
+    int kernel = 0;
+    int boundary = BOUNDARY_OPEN;
+    int halo_interval = 1;
+    int rebalance_interval = 0;
+    double rebalance_threshold = 0.1;
+    int demand = DEMAND_STATIONARY;
+    double demand_start_time = 0.0;
+    double target_precision = 0.0;
+    int precision_check_interval = 100;
+    unsigned long long seed = 0;
+    int num_replicas = 1;
+    int antithetic = 0;
+    int paired_scenario = 0;
+    int feed_interval = 0;
+    int feed_bins = 80;
+    int huge_pages = HUGE_PAGES_NONE;
+    double macro_density = 0.0;
+    int golden_reference = 0;
+    int tune_steps = 0;
+    int snapshot_interval = 0;
+    std::vector<float> interarrival_times;
+    std::vector<float> interarrival_probabilities;
+    std::vector<VehicleClass> vehicle_classes;
+
+    int loadFromFile(const std::string &file_name);
+
+    int loadFromLines(const std::vector<std::string> &input_lines);
+
+    int loadVehicleClasses(const std::string &file_name);
+
+    [[nodiscard]] int validate() const;
 };
 
 
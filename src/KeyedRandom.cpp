@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+
+#include "KeyedRandom.h"
+
+/**
+ * Constructor for the KeyedRandom
+ * @param inputs instance of the Inputs class with simulation inputs, whose seed is 0 to disable the keyed random numbers
+ */
+KeyedRandom::KeyedRandom(const Inputs &inputs) {
+    this->seed = inputs.seed;
+    this->antithetic = inputs.antithetic != 0;
+}
+
+/**
+ * Mixes the bits of a 64 bit integer with the finalizer of the SplitMix64 generator
+ * @param x the integer
+ * @return the mixed integer
+ */
+uint64_t KeyedRandom::mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Checks whether the simulation has a seed and draws keyed random numbers
+ * @return true if the random numbers are keyed, false otherwise
+ */
+bool KeyedRandom::isEnabled() const {
+    return this->seed != 0;
+}
+
+/**
+ * Draws the uniform random number in [0, 1) of an event
+ * @param key the identity of the subject of the event, the id of a Vehicle or the number of a Lane
+ * @param index the index of the event of the subject, like the age of a Vehicle or the number of a spawn
+ * @param stream the kind of the event
+ * @return the random number, or one minus it in an antithetic simulation
+ */
+double KeyedRandom::draw(const long key, const long index, const int stream) const {
+    uint64_t x = mix(this->seed ^ static_cast<uint64_t>(stream));
+    x = mix(x ^ static_cast<uint64_t>(key));
+    x = mix(x ^ static_cast<uint64_t>(index));
+    const double u = static_cast<double>(x >> 11) / static_cast<double>(uint64_t{1} << 53);
+    return this->antithetic ? 1.0 - u : u;
+}
+
+/**
+ * Draws the uniform random integer of an event, like a site picked among the remaining ones
+ * @param key the identity of the subject of the event
+ * @param index the index of the event of the subject
+ * @param stream the kind of the event
+ * @param count the number of integers to draw from
+ * @return the random integer in [0, count)
+ */
+int KeyedRandom::drawIndex(const long key, const long index, const int stream, const int count) const {
+    return std::min(static_cast<int>(this->draw(key, index, stream) * count), count - 1);
+}
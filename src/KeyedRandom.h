@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_KEYEDRANDOM_H
+#define CA_TRAFFIC_SIMULATION_KEYEDRANDOM_H
+
+#include <cstdint>
+
+#include "Inputs.h"
+
+// Streams of the keyed random numbers, one per kind of random event
+constexpr int STREAM_SWITCH = 0;
+constexpr int STREAM_SLOW_DOWN = 1;
+constexpr int STREAM_SPAWN_SPEED = 2;
+constexpr int STREAM_INTERARRIVAL = 3;
+constexpr int STREAM_POPULATE = 4;
+constexpr int STREAM_VEHICLE_CLASS = 5;
+constexpr int STREAM_ROUTE = 6;
+
+/**
+ * Class for the keyed random numbers of a simulation with a seed. Instead of being drawn in sequence, each random number
+ * is a hash of the seed and the identity of its event: the id and age in steps of the Vehicle for its lane switch and
+ * slow down, the id of a spawned Vehicle for its initial speed and class, the Lane and number of the spawn for the next
+ * interarrival time. Two simulations with the same seed then give the same random numbers to the same Vehicles even
+ * when their parameters differ (common random numbers), which makes the difference of their results much less noisy
+ * than with independent random numbers. An antithetic simulation draws one minus each random number instead.
+ *
+ * Without a seed the simulation draws its random numbers in sequence as before, and the class is disabled.
+ */
+class KeyedRandom {
+    uint64_t seed;
+    bool antithetic;
+
+public:
+    explicit KeyedRandom(const Inputs &inputs);
+
+    static uint64_t mix(uint64_t x);
+
+    [[nodiscard]] bool isEnabled() const;
+
+    [[nodiscard]] double draw(long key, long index, int stream) const;
+
+    [[nodiscard]] int drawIndex(long key, long index, int stream, int count) const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_KEYEDRANDOM_H
@@ -3,12 +3,14 @@
  */
 
 #include <cstdlib>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
 #include "Lane.h"
 #include "Vehicle.h"
 #include "Inputs.h"
+#include "KeyedRandom.h"
 
 /**
  * Constructor for the Lane class
@@ -17,8 +19,9 @@
  * @param process_data Contains the rank and size of the MPI process, represented
  *                     by an instance of the `ProcessData` class. This is used to
  *                     manage distributed simulation across multiple processes.
+ * @param demand the demand of Vehicles entering the Road, which schedules the first spawn of the Lane
  */
-Lane::Lane(const Inputs &inputs, const int lane_num, const ProcessData &process_data) {
+Lane::Lane(const Inputs &inputs, const int lane_num, const ProcessData &process_data, const Demand &demand) {
 #ifdef DEBUG
     std::cout << "creating lane " << lane_num << "...";
 #endif
@@ -46,7 +49,13 @@ Lane::Lane(const Inputs &inputs, const int lane_num, const ProcessData &process_
     std::cout << "done, lane " << lane_num << " created with length " << this->sites.size() << std::endl;
 #endif
 
-    this->steps_to_spawn = 0;
+    this->steps_to_spawn = demand.getInitialStepsToSpawn(lane_num);
+
+    // On a ring road the sites of a long Vehicle continue from the end of the Lane
+    this->periodic = inputs.boundary == BOUNDARY_PERIODIC;
+
+    // Count the Vehicles of each chunk of sites, so that the searches for Vehicles skip the empty chunks
+    this->chunk_counts.resize((this->sites.size() >> CHUNK_SHIFT) + 1, 0);
 }
 
 /**
@@ -71,18 +80,64 @@ int Lane::getLaneNumber() const {
  * @return whether or not the Lane has a Vehicle in the site
  */
 bool Lane::hasVehicleInSite(const int site) const {
-    return !this->sites[site].empty();
+    return this->sites[site] != nullptr;
+}
+
+/**
+ * Finds the nearest site at or downstream of a site that has a Vehicle, skipping the chunks of sites without Vehicles
+ * @param site the site to start the search from
+ * @return the nearest site with a Vehicle, -1 if there is none before the end of the Lane
+ */
+int Lane::findVehicleAhead(const int site) const {
+    const int size = this->getSize();
+    int i = site;
+    while (i < size) {
+        if (this->chunk_counts[i >> CHUNK_SHIFT] == 0) {
+            i = ((i >> CHUNK_SHIFT) + 1) << CHUNK_SHIFT;
+        } else if (this->sites[i] == nullptr) {
+            i++;
+        } else {
+            return i;
+        }
+    }
+    return -1;
 }
 
 /**
- * Adds a Vehicle to a site in the Lane
+ * Finds the nearest site at or upstream of a site that has a Vehicle, skipping the chunks of sites without Vehicles
+ * @param site the site to start the search from
+ * @return the nearest site with a Vehicle, -1 if there is none after the start of the Lane
+ */
+int Lane::findVehicleBehind(const int site) const {
+    int i = site;
+    while (i >= 0) {
+        if (this->chunk_counts[i >> CHUNK_SHIFT] == 0) {
+            i = ((i >> CHUNK_SHIFT) << CHUNK_SHIFT) - 1;
+        } else if (this->sites[i] == nullptr) {
+            i--;
+        } else {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Adds a Vehicle to an empty site in the Lane
  * @param site which site to add the Vehicle to
  * @param vehicle_ptr pointer to the Vehicle to add to the site
- * @return 0 if successful, nonzero otherwise
+ * @return 0 if successful, nonzero if the site is occupied
  */
 int Lane::addVehicle(const int site, Vehicle *vehicle_ptr) {
+    if (this->sites[site] != nullptr) {
+        std::cout << "error: vehicle " << vehicle_ptr->getId() << " entering occupied site " << site << " of lane "
+                << this->lane_num << "!" << std::endl;
+        return 1;
+    }
+
     // Place the Vehicle in the site
-    this->sites[site].push_back(vehicle_ptr);
+    this->sites[site] = vehicle_ptr;
+    this->chunk_counts[site >> CHUNK_SHIFT]++;
 
     // Return with zero errors
     return 0;
@@ -95,23 +150,302 @@ int Lane::addVehicle(const int site, Vehicle *vehicle_ptr) {
  */
 int Lane::removeVehicle(const int site) {
     // Remove the Vehicle from the site
-    this->sites[site].pop_front();
+    this->sites[site] = nullptr;
+    this->chunk_counts[site >> CHUNK_SHIFT]--;
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Places a Vehicle in all the sites it occupies, from its position back over its length. On the open road the sites of
+ * a long Vehicle behind the start of the Lane are left out until it has fully entered the Lane.
+ * @param vehicle_ptr pointer to the Vehicle to place
+ * @return 0 if successful, nonzero if one of the sites is occupied
+ */
+int Lane::occupySites(Vehicle *vehicle_ptr) {
+    for (int i = 0; i < vehicle_ptr->getLength(); i++) {
+        int site = vehicle_ptr->getPosition() - i;
+        if (site < 0) {
+            if (!this->periodic) {
+                break;
+            }
+            site += this->getSize();
+        }
+        if (const int status = this->addVehicle(site, vehicle_ptr); status != 0) {
+            return status;
+        }
+    }
 
     // Return with zero errors
     return 0;
 }
 
 /**
- * Attempts to spawn a Vehicle that has entered the Lane at the first site. Uses a CDF to sample to determine whether
+ * Removes a Vehicle from all the sites it occupies, from its position back over its length
+ * @param vehicle_ptr pointer to the Vehicle to remove
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::vacateSites(const Vehicle *vehicle_ptr) {
+    for (int i = 0; i < vehicle_ptr->getLength(); i++) {
+        int site = vehicle_ptr->getPosition() - i;
+        if (site < 0) {
+            if (!this->periodic) {
+                break;
+            }
+            site += this->getSize();
+        }
+        this->removeVehicle(site);
+    }
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Getter method for the Vehicles in the Lane, ordered by decreasing position
+ * @return the Vehicles in the Lane, starting with the most downstream one
+ */
+const std::deque<Vehicle *> &Lane::getOrderedVehicles() const {
+    return this->ordered_vehicles;
+}
+
+/**
+ * Getter for the Vehicles of the Lane that propose to switch to one of its neighbour Lanes in the current step
+ * @param side the side of the neighbour Lane
+ * @return the Vehicles proposing to switch to that side, ordered by decreasing position
+ */
+const std::vector<Vehicle *> &Lane::getSwitchIntents(const int side) const {
+    return this->switch_intents[side];
+}
+
+/**
+ * Proposes the lane switches of the Vehicles of the Lane: each Vehicle updates its gaps and decides on the Lane it
+ * would switch to, without changing the Road, and the Vehicles that would switch are collected per side in the intents
+ * of the Lane. Only the Lane and its own Vehicles are written, so the Lanes propose independently.
+ * @param road_ptr pointer to the Road of the Lane
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::proposeLaneSwitches(const Road *road_ptr) {
+    const std::array<Lane *, 2> &neighbour_lanes = road_ptr->getNeighbourLanes(this->lane_num);
+    this->switch_intents[SIDE_RIGHT].clear();
+    this->switch_intents[SIDE_LEFT].clear();
+    for (const auto &vehicle: this->ordered_vehicles) {
+        vehicle->updateGaps(road_ptr);
+#ifdef DEBUG
+        vehicle->printGaps();
+#endif
+        vehicle->proposeLaneSwitch(road_ptr);
+        for (int side = SIDE_RIGHT; side <= SIDE_LEFT; side++) {
+            if (vehicle->getTargetLane() != nullptr && vehicle->getTargetLane() == neighbour_lanes[side]) {
+                this->switch_intents[side].push_back(vehicle);
+            }
+        }
+    }
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Resolves the lane switches proposed into the Lane by the Vehicles of its neighbour Lanes. The sites they target are
+ * empty, but two Vehicles from both sides can target overlapping sites, in which case the one from the lower numbered
+ * (right) Lane has priority and the other one stays in its Lane. The Vehicles from one side never overlap each other,
+ * as they leave the same Lane. The accepted Vehicles become the arrivals of the Lane, ordered by decreasing position.
+ * Only the Lane and the Vehicles proposing to switch into it are written, so the Lanes resolve independently.
+ * @param road_ptr pointer to the Road of the Lane
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::resolveLaneSwitches(const Road *road_ptr) {
+    static const std::vector<Vehicle *> no_intents;
+    const std::array<Lane *, 2> &neighbour_lanes = road_ptr->getNeighbourLanes(this->lane_num);
+    const std::vector<Vehicle *> &from_right = neighbour_lanes[SIDE_RIGHT] != nullptr
+                                                   ? neighbour_lanes[SIDE_RIGHT]->getSwitchIntents(SIDE_LEFT)
+                                                   : no_intents;
+    const std::vector<Vehicle *> &from_left = neighbour_lanes[SIDE_LEFT] != nullptr
+                                                  ? neighbour_lanes[SIDE_LEFT]->getSwitchIntents(SIDE_RIGHT)
+                                                  : no_intents;
+
+    // Walk both intents downstream to upstream together, as they are ordered by decreasing position, accepting each
+    // Vehicle from the left unless it overlaps the nearest Vehicle from the right that is not entirely ahead of it
+    this->switch_arrivals.clear();
+    size_t r = 0;
+    for (const auto &vehicle: from_left) {
+        while (r < from_right.size() && from_right[r]->getRear() > vehicle->getPosition()) {
+            this->switch_arrivals.push_back(from_right[r++]);
+        }
+        if (r < from_right.size() && from_right[r]->getPosition() >= vehicle->getRear()) {
+            vehicle->rejectLaneSwitch();
+        } else {
+            this->switch_arrivals.push_back(vehicle);
+        }
+    }
+    while (r < from_right.size()) {
+        this->switch_arrivals.push_back(from_right[r++]);
+    }
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Commits the resolved lane switches of the Lane in bulk: the Vehicles whose switch out of the Lane was accepted leave
+ * their sites and the ordered Vehicles, and the arrivals take their sites and are merged into the ordered Vehicles.
+ * Only the Lane and its arrivals are written, so the Lanes commit independently.
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::commitLaneSwitches() {
+    // Remove the Vehicles leaving the Lane, which still have their accepted target Lane
+    bool departed = false;
+    for (const auto &intents: this->switch_intents) {
+        for (const auto &vehicle: intents) {
+            if (vehicle->getTargetLane() != nullptr) {
+                this->vacateSites(vehicle);
+                departed = true;
+            }
+        }
+    }
+    if (departed) {
+        this->ordered_vehicles.erase(std::remove_if(this->ordered_vehicles.begin(), this->ordered_vehicles.end(),
+                                                    [](const Vehicle *vehicle) {
+                                                        return vehicle->getTargetLane() != nullptr;
+                                                    }), this->ordered_vehicles.end());
+    }
+
+    // Move the arrivals into the Lane
+    for (const auto &vehicle: this->switch_arrivals) {
+#ifdef DEBUG
+        std::cout << "vehicle " << vehicle->getId() << " switched lane " << vehicle->getLane()->getLaneNumber()
+                << " -> " << this->lane_num << std::endl;
+#endif
+        if (const int status = this->occupySites(vehicle); status != 0) {
+            return status;
+        }
+        vehicle->commitLaneSwitch();
+    }
+    return this->mergeVehicles(&this->switch_arrivals);
+}
+
+/**
+ * Merges the Vehicles that switched into the Lane with the ordered Vehicles of the Lane. Vehicles never overtake
+ * within a Lane, so the remaining Vehicles are already ordered and a linear merge keeps the Lane ordered.
+ * @param arrivals the Vehicles that switched into the Lane, ordered by decreasing position
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::mergeVehicles(std::vector<Vehicle *> *arrivals) {
+    if (arrivals->empty()) {
+        return 0;
+    }
+
+    std::deque<Vehicle *> merged;
+    std::merge(this->ordered_vehicles.begin(), this->ordered_vehicles.end(), arrivals->begin(), arrivals->end(),
+               std::back_inserter(merged), [](const Vehicle *a, const Vehicle *b) {
+                   return a->getPosition() > b->getPosition();
+               });
+    this->ordered_vehicles.swap(merged);
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Removes the Vehicles that left the end of the Lane from the ordered Vehicles of the Lane. A Vehicle can only leave
+ * the Lane if all the Vehicles ahead of it left too, so these are always at the front.
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::removeExitedVehicles() {
+    while (!this->ordered_vehicles.empty()) {
+        const Vehicle *vehicle = this->ordered_vehicles.front();
+        const int site = vehicle->getPosition();
+        if (this->sites[site] == vehicle) {
+            break;
+        }
+        this->ordered_vehicles.pop_front();
+    }
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Removes all the Vehicles from the sites and the ordered Vehicles of the Lane, without deleting them
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::clearVehicles() {
+    for (const auto &vehicle: this->ordered_vehicles) {
+        this->vacateSites(vehicle);
+    }
+    this->ordered_vehicles.clear();
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Moves the Vehicles that wrapped around from the end to the start of the Lane on a ring road to the back of the
+ * ordered Vehicles of the Lane. These were the most downstream Vehicles, so they are always at the front.
+ * @return the number of Vehicles that wrapped around
+ */
+int Lane::rotateWrappedVehicles() {
+    int num_wrapped = 0;
+    while (num_wrapped < static_cast<int>(this->ordered_vehicles.size()) &&
+           this->ordered_vehicles.front()->hasWrapped()) {
+        this->ordered_vehicles.push_back(this->ordered_vehicles.front());
+        this->ordered_vehicles.pop_front();
+        num_wrapped++;
+    }
+    return num_wrapped;
+}
+
+/**
+ * Places a Vehicle in its sites of the Lane when populating the Road or when it enters the Lane from another Road. The
+ * Vehicles must be placed in order of decreasing position.
+ * @param vehicle_ptr pointer to the Vehicle to place
+ * @return 0 if successful, nonzero otherwise
+ */
+int Lane::placeVehicle(Vehicle *vehicle_ptr) {
+    if (const int status = this->occupySites(vehicle_ptr); status != 0) {
+        return status;
+    }
+    this->ordered_vehicles.push_back(vehicle_ptr);
+
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Selects the class of a spawned Vehicle from the shares of the Vehicle classes
+ * @param vehicle_classes the Vehicle classes
+ * @param u a uniform random number
+ * @return the number of the class
+ */
+static int selectVehicleClass(const std::vector<VehicleClass> &vehicle_classes, const double u) {
+    double total_share = 0.0;
+    for (const auto &vehicle_class: vehicle_classes) {
+        total_share += vehicle_class.share;
+    }
+    double cumulative_share = 0.0;
+    for (size_t i = 0; i + 1 < vehicle_classes.size(); i++) {
+        cumulative_share += vehicle_classes[i].share;
+        if (u * total_share < cumulative_share) {
+            return static_cast<int>(i);
+        }
+    }
+    return static_cast<int>(vehicle_classes.size()) - 1;
+}
+
+/**
+ * Attempts to spawn a Vehicle that has entered the Lane at the first site. Uses the Demand to determine whether
  * or not a Vehicle was spawned.
  * @param inputs instance of the Inputs class with the simulation inputs
+ * @param time the simulation time
  * @param vehicles pointer to list of Vehicles to add the spawned Vehicles to
  * @param next_id_ptr pointer to the id number of the next spawned Vehicle
- * @param interarrival_time_cdf CDF of the Vehicle interarrival times
+ * @param demand the demand of Vehicles entering the Road
  * @return
  */
-int Lane::attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr,
-                       const CDF *interarrival_time_cdf) {
+int Lane::attemptSpawn(const Inputs &inputs, const int time, std::vector<Vehicle *> *vehicles, int *next_id_ptr,
+                       Demand *demand) {
     if (this->steps_to_spawn == 0) {
         if (!this->hasVehicleInSite(0)) {
             // Spawn Vehicle
@@ -119,16 +453,33 @@ int Lane::attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, i
             std::cout << "creating vehicle " << (*next_id_ptr) << " in lane " << this->lane_num << " at site " << 0
                     << std::endl;
 #endif
-            this->sites[0].push_front(new Vehicle(this, (*next_id_ptr)++, 0, inputs));
-            vehicles->push_back(this->sites[0].front());
+            // Randomly choose the class of the Vehicle from the shares of the classes, if there are several
+            const KeyedRandom random(inputs);
+            int vehicle_class = 0;
+            if (inputs.vehicle_classes.size() > 1) {
+                const double u = random.isEnabled()
+                                     ? random.draw(*next_id_ptr, 0, STREAM_VEHICLE_CLASS)
+                                     : static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+                vehicle_class = selectVehicleClass(inputs.vehicle_classes, u);
+            }
+            this->sites[0] = new Vehicle(this, (*next_id_ptr)++, 0, inputs, vehicle_class);
+            this->chunk_counts[0]++;
+            vehicles->push_back(this->sites[0]);
+            this->ordered_vehicles.push_back(this->sites[0]);
 
             // Randomly choose the Vehicles initial speed to be zero bases in slow down probability
-            if (static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX) < inputs.prob_slow_down) {
+            const double prob_slow_down = inputs.vehicle_classes.empty()
+                                              ? inputs.prob_slow_down
+                                              : inputs.vehicle_classes[vehicle_class].prob_slow_down;
+            const double u = random.isEnabled()
+                                 ? random.draw(this->sites[0]->getId(), 0, STREAM_SPAWN_SPEED)
+                                 : static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+            if (u < prob_slow_down) {
                 vehicles->back()->setSpeed(0);
             }
 
             // "Schedule" next Vehicle spawn
-            this->steps_to_spawn = static_cast<int>(interarrival_time_cdf->query() / inputs.step_size);
+            this->steps_to_spawn = demand->drawStepsToSpawn(this->lane_num, time);
         }
     } else {
         this->steps_to_spawn--;
@@ -145,10 +496,10 @@ int Lane::attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, i
 void Lane::printLane() const {
     std::ostringstream lane_string_stream;
     for (const auto &site: this->sites) {
-        if (site.empty()) {
+        if (site == nullptr) {
             lane_string_stream << "[   ]";
         } else {
-            lane_string_stream << "[" << std::setw(3) << site.front()->getId() << "]";
+            lane_string_stream << "[" << std::setw(3) << site->getId() << "]";
         }
     }
     std::cout << lane_string_stream.str() << std::endl;
@@ -7,25 +7,32 @@
 
 #include <vector>
 #include <deque>
+#include <array>
 
 #include "Inputs.h"
-#include "CDF.h"
+#include "Demand.h"
 #include "ProcessData.h"
 
 // Forward Declarations
 class Vehicle;
+class Road;
 
 /**
  * Class for a lane in the road of the simulation. Each lane contains the "sites" for the vehicles and allows access
  * to all the information about the vehicles on the road through its methods.
  */
 class Lane {
-    std::vector<std::deque<Vehicle *> > sites;
+    std::vector<Vehicle *> sites;
+    std::deque<Vehicle *> ordered_vehicles;
+    std::vector<int> chunk_counts;
+    std::array<std::vector<Vehicle *>, 2> switch_intents;
+    std::vector<Vehicle *> switch_arrivals;
     int lane_num;
     int steps_to_spawn;
+    bool periodic;
 
 public:
-    Lane(const Inputs &inputs, int lane_num, const ProcessData &process_data);
+    Lane(const Inputs &inputs, int lane_num, const ProcessData &process_data, const Demand &demand);
 
     [[nodiscard]] int getSize() const;
 
@@ -33,12 +40,40 @@ public:
 
     [[nodiscard]] bool hasVehicleInSite(int site) const;
 
+    [[nodiscard]] int findVehicleAhead(int site) const;
+
+    [[nodiscard]] int findVehicleBehind(int site) const;
+
     int addVehicle(int site, Vehicle *vehicle_ptr);
 
     int removeVehicle(int site);
 
-    int attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr,
-                     const CDF *interarrival_time_cdf);
+    int occupySites(Vehicle *vehicle_ptr);
+
+    int vacateSites(const Vehicle *vehicle_ptr);
+
+    [[nodiscard]] const std::deque<Vehicle *> &getOrderedVehicles() const;
+
+    [[nodiscard]] const std::vector<Vehicle *> &getSwitchIntents(int side) const;
+
+    int proposeLaneSwitches(const Road *road_ptr);
+
+    int resolveLaneSwitches(const Road *road_ptr);
+
+    int commitLaneSwitches();
+
+    int mergeVehicles(std::vector<Vehicle *> *arrivals);
+
+    int removeExitedVehicles();
+
+    int clearVehicles();
+
+    int rotateWrappedVehicles();
+
+    int placeVehicle(Vehicle *vehicle_ptr);
+
+    int attemptSpawn(const Inputs &inputs, int time, std::vector<Vehicle *> *vehicles, int *next_id_ptr,
+                     Demand *demand);
 #ifdef DEBUG
     void printLane() const;
 #endif
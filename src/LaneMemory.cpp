@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "LaneMemory.h"
+
+// Most pages of a cell array whose NUMA node is looked up for the memory locality report
+constexpr size_t MAX_SAMPLED_PAGES = 4096;
+
+/**
+ * Rounds a number of bytes up to whole huge pages
+ * @param size the number of bytes
+ * @return the number of bytes of the huge pages
+ */
+static size_t roundToHugePages(const size_t size) {
+    return (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+/**
+ * Allocates the memory of a cell array of a Lane, without writing to it. The arrays of less than a huge page, or
+ * without huge pages, come from the heap, the others are mapped aligned to huge pages, from the explicit huge page pool
+ * if requested and not exhausted, and advised to use transparent huge pages otherwise
+ * @param size the number of bytes of the array
+ * @param huge_pages the huge pages to use
+ * @return pointer to the memory
+ */
+void *allocateLaneMemory(const size_t size, const int huge_pages) {
+    if (huge_pages == HUGE_PAGES_NONE || size < HUGE_PAGE_SIZE) {
+        if (void *pointer = std::malloc(std::max(size, size_t{1})); pointer != nullptr) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+    const size_t mapped_size = roundToHugePages(size);
+    if (huge_pages == HUGE_PAGES_EXPLICIT) {
+        if (void *pointer = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                                 -1, 0); pointer != MAP_FAILED) {
+            return pointer;
+        }
+    }
+
+    // Map a huge page more than needed and trim the ends, so that the array starts on a huge page boundary where the
+    // kernel can back it with transparent huge pages
+    void *mapping = mmap(nullptr, mapped_size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                         0);
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const auto start = reinterpret_cast<uintptr_t>(mapping);
+    const uintptr_t aligned_start = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    if (aligned_start > start) {
+        munmap(mapping, aligned_start - start);
+    }
+    if (const size_t tail_size = start + HUGE_PAGE_SIZE - aligned_start; tail_size > 0) {
+        munmap(reinterpret_cast<void *>(aligned_start + mapped_size), tail_size);
+    }
+    auto *pointer = reinterpret_cast<void *>(aligned_start);
+    madvise(pointer, mapped_size, MADV_HUGEPAGE);
+    return pointer;
+}
+
+/**
+ * Frees the memory of a cell array of a Lane
+ * @param pointer pointer to the memory
+ * @param size the number of bytes of the array
+ * @param huge_pages the huge pages it was allocated with
+ */
+void freeLaneMemory(void *pointer, const size_t size, const int huge_pages) {
+    if (huge_pages == HUGE_PAGES_NONE || size < HUGE_PAGE_SIZE) {
+        std::free(pointer);
+        return;
+    }
+    munmap(pointer, roundToHugePages(size));
+}
+
+/**
+ * Reads the amount of memory of the process backed by huge pages from the kernel
+ * @return the number of kilobytes of transparent and explicit huge pages, 0 if unknown
+ */
+static long readHugePageMemory() {
+    std::ifstream file("/proc/self/smaps_rollup");
+    std::string line;
+    long size = 0;
+    while (std::getline(file, line)) {
+        if (line.rfind("AnonHugePages:", 0) == 0 || line.rfind("Private_Hugetlb:", 0) == 0) {
+            size += std::stol(line.substr(line.find(':') + 1));
+        }
+    }
+    return size;
+}
+
+/**
+ * Prints the memory locality of the cell arrays of the Lanes for each thread updating them: the NUMA node the thread
+ * runs on, and how many of the sampled pages of the arrays of its Lanes are on that node, on another node, or not in
+ * memory yet. The Lanes are divided between the threads like in the parallel steps, so the threads should be bound to
+ * their cores (e.g. OMP_PROC_BIND=true) for the report to be meaningful. The memory backed by huge pages follows.
+ * @param lane_arrays the start and the number of bytes of each cell array of each Lane
+ * @param num_threads the number of threads updating the Lanes
+ * @param huge_pages the huge pages the cell arrays were allocated with
+ * @return 0 if successful, nonzero otherwise
+ */
+int printMemoryLocality(const std::vector<std::vector<std::pair<const void *, size_t> > > &lane_arrays,
+                        const int num_threads, const int huge_pages) {
+    const int num_lanes = static_cast<int>(lane_arrays.size());
+    const long page_size = sysconf(_SC_PAGESIZE);
+    std::vector<int> nodes(num_threads, -1);
+    std::vector<long> num_local(num_threads, 0);
+    std::vector<long> num_remote(num_threads, 0);
+    std::vector<long> num_absent(num_threads, 0);
+
+#pragma omp parallel num_threads(num_threads)
+    {
+        const int thread = omp_get_thread_num();
+        unsigned int cpu = 0;
+        unsigned int node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            nodes[thread] = static_cast<int>(node);
+        }
+        std::vector<void *> pages;
+        std::vector<int> status;
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < num_lanes; i++) {
+            for (const auto &[start, size]: lane_arrays[i]) {
+                // Sample the pages of the array evenly
+                const size_t num_pages = (size + page_size - 1) / page_size;
+                const size_t stride = std::max(size_t{1}, num_pages / MAX_SAMPLED_PAGES);
+                pages.clear();
+                for (size_t p = 0; p < num_pages; p += stride) {
+                    pages.push_back(const_cast<char *>(static_cast<const char *>(start)) + p * page_size);
+                }
+                status.assign(pages.size(), -1);
+
+                // Look up the node of each page without moving it, which fails for the pages not in memory
+                if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+                    num_absent[thread] += static_cast<long>(pages.size());
+                    continue;
+                }
+                for (const int page_node: status) {
+                    if (page_node < 0) {
+                        num_absent[thread]++;
+                    } else if (page_node == nodes[thread]) {
+                        num_local[thread]++;
+                    } else {
+                        num_remote[thread]++;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        const long num_sampled = num_local[t] + num_remote[t] + num_absent[t];
+        std::cout << "memory locality: thread " << t << " on node " << nodes[t] << ", " << num_local[t] << " of "
+                << num_sampled << " sampled lane pages local, " << num_remote[t] << " remote, " << num_absent[t]
+                << " not in memory" << std::endl;
+    }
+    std::cout << "huge pages: " << (huge_pages == HUGE_PAGES_EXPLICIT
+                                        ? "explicit"
+                                        : huge_pages == HUGE_PAGES_TRANSPARENT ? "transparent" : "none")
+            << ", " << readHugePageMemory() / 1024 << " MiB of the process backed by huge pages" << std::endl;
+
+    // Return with no errors
+    return 0;
+}
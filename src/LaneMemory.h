@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_LANEMEMORY_H
+#define CA_TRAFFIC_SIMULATION_LANEMEMORY_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Inputs.h"
+
+// Size of the huge pages the large cell arrays of the Lanes are placed in
+constexpr size_t HUGE_PAGE_SIZE = size_t{1} << 21;
+
+void *allocateLaneMemory(size_t size, int huge_pages);
+
+void freeLaneMemory(void *pointer, size_t size, int huge_pages);
+
+/**
+ * Allocator for the cell arrays of the Lanes. The arrays of at least a huge page are mapped directly from the kernel,
+ * aligned to huge pages, and backed with transparent huge pages or explicit (hugetlbfs) huge pages when requested. As
+ * with the default allocator, the memory of an array is only placed on a NUMA node when its pages are first written,
+ * so the arrays of a Lane are placed next to the thread that fills them.
+ */
+template<typename T>
+class LaneAllocator {
+public:
+    using value_type = T;
+
+    int huge_pages;
+
+    explicit LaneAllocator(const int huge_pages = HUGE_PAGES_NONE) : huge_pages(huge_pages) {
+    }
+
+    template<typename U>
+    explicit LaneAllocator(const LaneAllocator<U> &other) : huge_pages(other.huge_pages) {
+    }
+
+    T *allocate(const size_t n) {
+        return static_cast<T *>(allocateLaneMemory(n * sizeof(T), this->huge_pages));
+    }
+
+    void deallocate(T *pointer, const size_t n) {
+        freeLaneMemory(pointer, n * sizeof(T), this->huge_pages);
+    }
+
+    template<typename U>
+    bool operator==(const LaneAllocator<U> &other) const { return this->huge_pages == other.huge_pages; }
+
+    template<typename U>
+    bool operator!=(const LaneAllocator<U> &other) const { return this->huge_pages != other.huge_pages; }
+};
+
+template<typename T>
+using LaneVector = std::vector<T, LaneAllocator<T> >;
+
+int printMemoryLocality(const std::vector<std::vector<std::pair<const void *, size_t> > > &lane_arrays,
+                        int num_threads, int huge_pages);
+
+
+#endif //CA_TRAFFIC_SIMULATION_LANEMEMORY_H
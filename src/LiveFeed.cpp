@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LiveFeed.h"
+
+// Marker at the start of the shared memory of a live feed, written once it is ready
+constexpr uint32_t FEED_MAGIC = 0x43415453;
+
+// Alignment of the slots of the live feed, one cache line so that slots never share a line
+constexpr size_t FEED_ALIGNMENT = 64;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "the live feed needs lock free atomics to share them between processes");
+
+/**
+ * Rounds a number of bytes up to the alignment of the slots of the live feed
+ * @param size the number of bytes
+ * @return the aligned number of bytes
+ */
+static size_t alignSize(const size_t size) {
+    return (size + FEED_ALIGNMENT - 1) / FEED_ALIGNMENT * FEED_ALIGNMENT;
+}
+
+/**
+ * Constructor for the LiveFeed, which is neither created nor attached yet
+ */
+LiveFeed::LiveFeed() {
+    this->owner = false;
+    this->header = nullptr;
+    this->mapped_size = 0;
+}
+
+/**
+ * Destructor of the LiveFeed, which unmaps the shared memory and removes it if the LiveFeed created it. The viewers
+ * still attached keep their mapping
+ */
+LiveFeed::~LiveFeed() {
+    if (this->header == nullptr) {
+        return;
+    }
+    if (this->owner) {
+        this->finish();
+    }
+    munmap(this->header, this->mapped_size);
+    if (this->owner) {
+        shm_unlink(this->name.c_str());
+    }
+}
+
+/**
+ * Gets the name of the shared memory of the live feed of a process
+ * @param rank the rank of the process
+ * @return the name of the shared memory
+ */
+std::string LiveFeed::getName(const int rank) {
+    return "/cats-feed-" + std::to_string(rank);
+}
+
+/**
+ * Gets a slot of the ring buffer of the live feed
+ * @param index the number of the snapshot written into the slot
+ * @return pointer to the slot
+ */
+FeedSlot *LiveFeed::getSlot(const uint64_t index) const {
+    char *slots = reinterpret_cast<char *>(this->header) + alignSize(sizeof(FeedHeader));
+    return reinterpret_cast<FeedSlot *>(slots + (index % FEED_NUM_SLOTS) * this->header->slot_size);
+}
+
+/**
+ * Creates the shared memory of the live feed of a process, replacing the one of an earlier simulation
+ * @param rank the rank of the process
+ * @param num_lanes the number of Lanes
+ * @param num_bins the number of bins of each Lane
+ * @return 0 if successful, nonzero otherwise
+ */
+int LiveFeed::create(const int rank, const int num_lanes, const int num_bins) {
+    this->name = getName(rank);
+    const size_t slot_size = alignSize(sizeof(FeedSlot) + sizeof(uint32_t) * 2 * num_lanes * num_bins);
+    const size_t size = alignSize(sizeof(FeedHeader)) + FEED_NUM_SLOTS * slot_size;
+
+    // Create the shared memory anew, so that viewers still attached to a previous feed are not affected
+    shm_unlink(this->name.c_str());
+    const int file = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (file < 0) {
+        std::cout << "error: failure to create the shared memory " << this->name << " of the live feed!" << std::endl;
+        return 1;
+    }
+    if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+        std::cout << "error: failure to size the shared memory " << this->name << " of the live feed!" << std::endl;
+        close(file);
+        shm_unlink(this->name.c_str());
+        return 1;
+    }
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+    if (memory == MAP_FAILED) {
+        std::cout << "error: failure to map the shared memory " << this->name << " of the live feed!" << std::endl;
+        shm_unlink(this->name.c_str());
+        return 1;
+    }
+    this->owner = true;
+    this->mapped_size = size;
+    this->header = static_cast<FeedHeader *>(memory);
+
+    // Lay out the header and the slots in the zeroed memory, and mark the feed ready last
+    this->header->num_lanes = num_lanes;
+    this->header->num_bins = num_bins;
+    this->header->slot_size = static_cast<int32_t>(slot_size);
+    new(&this->header->num_published) std::atomic<uint64_t>(0);
+    new(&this->header->finished) std::atomic<uint32_t>(0);
+    for (int i = 0; i < FEED_NUM_SLOTS; i++) {
+        new(&this->getSlot(i)->sequence) std::atomic<uint32_t>(0);
+    }
+    this->bins.assign(static_cast<size_t>(2) * num_lanes * num_bins, 0);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = FEED_MAGIC;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Attaches to the shared memory of the live feed of a process for reading
+ * @param rank the rank of the process
+ * @return 0 if successful, nonzero otherwise
+ */
+int LiveFeed::attach(const int rank) {
+    this->name = getName(rank);
+    const int file = shm_open(this->name.c_str(), O_RDONLY, 0);
+    if (file < 0) {
+        std::cout << "error: no live feed " << this->name << " is published!" << std::endl;
+        return 1;
+    }
+    struct stat file_status{};
+    if (fstat(file, &file_status) != 0 || static_cast<size_t>(file_status.st_size) < sizeof(FeedHeader)) {
+        std::cout << "error: the live feed " << this->name << " is not ready!" << std::endl;
+        close(file);
+        return 1;
+    }
+    void *memory = mmap(nullptr, file_status.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (memory == MAP_FAILED) {
+        std::cout << "error: failure to map the live feed " << this->name << "!" << std::endl;
+        return 1;
+    }
+    this->mapped_size = file_status.st_size;
+    this->header = static_cast<FeedHeader *>(memory);
+
+    // Check that the feed is ready and that its slots fit in the shared memory
+    if (this->header->magic != FEED_MAGIC || alignSize(sizeof(FeedHeader)) + FEED_NUM_SLOTS *
+                                             static_cast<size_t>(this->header->slot_size) > this->mapped_size) {
+        std::cout << "error: the live feed " << this->name << " is not ready!" << std::endl;
+        munmap(this->header, this->mapped_size);
+        this->header = nullptr;
+        return 1;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Getter for the number of Lanes of the live feed
+ * @return the number of Lanes
+ */
+int LiveFeed::getNumLanes() const {
+    return this->header->num_lanes;
+}
+
+/**
+ * Getter for the number of bins of each Lane of the live feed
+ * @return the number of bins
+ */
+int LiveFeed::getNumBins() const {
+    return this->header->num_bins;
+}
+
+/**
+ * Downsamples the speeds of the sites of a Lane into the bins of the next snapshot, counting the Vehicles and summing
+ * their speeds in each bin
+ * @param lane the number of the Lane
+ * @param speeds the speeds of the sites of the Lane, -1 for the empty sites
+ * @return 0 if successful, nonzero otherwise
+ */
+int LiveFeed::binLane(const int lane, const Span<int8_t> &speeds) {
+    const int num_bins = this->header->num_bins;
+    uint32_t *lane_bins = this->bins.data() + static_cast<size_t>(2) * lane * num_bins;
+    std::fill(lane_bins, lane_bins + 2 * num_bins, 0);
+    const size_t size = speeds.size();
+    for (size_t site = 0; site < size; site++) {
+        if (speeds[site] >= 0) {
+            const size_t bin = site * num_bins / size;
+            lane_bins[2 * bin]++;
+            lane_bins[2 * bin + 1] += speeds[site];
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Writes the next snapshot, with the summary counters and the bins of all the Lanes, into the next slot of the ring
+ * buffer under its sequence lock
+ * @param summary the summary counters of the snapshot
+ * @return 0 if successful, nonzero otherwise
+ */
+int LiveFeed::publish(const FeedSummary &summary) {
+    const uint64_t index = this->header->num_published.load(std::memory_order_relaxed);
+    FeedSlot *slot = this->getSlot(index);
+    const uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot->summary, &summary, sizeof(FeedSummary));
+    std::memcpy(reinterpret_cast<char *>(slot + 1), this->bins.data(), this->bins.size() * sizeof(uint32_t));
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    this->header->num_published.store(index + 1, std::memory_order_release);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Getter for the number of snapshots published in the live feed so far
+ * @return the number of snapshots
+ */
+uint64_t LiveFeed::getNumPublished() const {
+    return this->header->num_published.load(std::memory_order_acquire);
+}
+
+/**
+ * Checks whether the simulation of the live feed has finished, so that no more snapshots follow
+ * @return whether the simulation has finished
+ */
+bool LiveFeed::isFinished() const {
+    return this->header->finished.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * Marks the live feed finished
+ * @return 0 if successful, nonzero otherwise
+ */
+int LiveFeed::finish() {
+    this->header->finished.store(1, std::memory_order_release);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Copies the latest snapshot of the live feed, retrying whenever the simulation wrote into its slot meanwhile
+ * @param summary_ptr pointer to the summary counters of the snapshot
+ * @param bins_ptr pointer to the number of Vehicles and the sum of their speeds of each bin of each Lane
+ * @return 0 if successful, nonzero if no snapshot was published yet
+ */
+int LiveFeed::readLatest(FeedSummary *summary_ptr, std::vector<uint32_t> *bins_ptr) const {
+    bins_ptr->resize(static_cast<size_t>(2) * this->header->num_lanes * this->header->num_bins);
+    while (true) {
+        const uint64_t num_published = this->getNumPublished();
+        if (num_published == 0) {
+            return 1;
+        }
+        const FeedSlot *slot = this->getSlot(num_published - 1);
+        const uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0) {
+            continue;
+        }
+        std::memcpy(summary_ptr, &slot->summary, sizeof(FeedSummary));
+        std::memcpy(bins_ptr->data(), slot + 1, bins_ptr->size() * sizeof(uint32_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == sequence) {
+            return 0;
+        }
+    }
+}
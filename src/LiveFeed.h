@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_LIVEFEED_H
+#define CA_TRAFFIC_SIMULATION_LIVEFEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Span.h"
+
+// Number of snapshots kept in the ring buffer of the live feed
+constexpr int FEED_NUM_SLOTS = 4;
+
+/**
+ * Structure for the summary counters of a snapshot of the live feed
+ */
+struct FeedSummary {
+    int64_t time;
+    int64_t lane_offset;
+    int64_t lane_size;
+    int64_t num_vehicles;
+    int64_t num_samples;
+    double travel_time;
+    double flow;
+    double mean_speed;
+};
+
+/**
+ * Structure for the header at the start of the shared memory of the live feed, followed by its slots
+ */
+struct FeedHeader {
+    uint32_t magic;
+    int32_t num_lanes;
+    int32_t num_bins;
+    int32_t slot_size;
+    std::atomic<uint64_t> num_published;
+    std::atomic<uint32_t> finished;
+};
+
+/**
+ * Structure for the start of a slot of the live feed, followed by the number of Vehicles and the sum of their speeds in
+ * each bin of each Lane
+ */
+struct FeedSlot {
+    std::atomic<uint32_t> sequence;
+    FeedSummary summary;
+};
+
+/**
+ * Class for a live feed of the state of the simulation in POSIX shared memory named "/cats-feed-<rank>", for viewers in
+ * other processes. Every snapshot holds the summary counters of the simulation and the Lanes of the process downsampled
+ * into bins of sites, with the number of Vehicles and the sum of their speeds of each bin. The snapshots are written in
+ * turn into a ring buffer of slots, each guarded by a sequence lock: the sequence of a slot is odd while it is written,
+ * so a viewer copies the latest slot and retries if its sequence was odd or changed meanwhile. The simulation never
+ * waits for the viewers, and the viewers never write to the feed.
+ */
+class LiveFeed {
+    std::string name;
+    bool owner;
+    FeedHeader *header;
+    size_t mapped_size;
+    std::vector<uint32_t> bins;
+
+    [[nodiscard]] FeedSlot *getSlot(uint64_t index) const;
+
+public:
+    LiveFeed();
+
+    ~LiveFeed();
+
+    static std::string getName(int rank);
+
+    int create(int rank, int num_lanes, int num_bins);
+
+    int attach(int rank);
+
+    [[nodiscard]] int getNumLanes() const;
+
+    [[nodiscard]] int getNumBins() const;
+
+    int binLane(int lane, const Span<int8_t> &speeds);
+
+    int publish(const FeedSummary &summary);
+
+    [[nodiscard]] uint64_t getNumPublished() const;
+
+    [[nodiscard]] bool isFinished() const;
+
+    int finish();
+
+    int readLatest(FeedSummary *summary_ptr, std::vector<uint32_t> *bins_ptr) const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_LIVEFEED_H
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "MacroSegment.h"
+
+/**
+ * Constructor for the MacroSegment, an empty segment whose fundamental diagram follows from the CA rules of the
+ * inputs: the Vehicles flow freely at the maximum speed less the slow down probability, jams hold a Vehicle per site
+ * and dissolve backward at one site per step less the slow down probability, and the capacity is where the two
+ * branches of the diagram meet
+ * @param inputs instance of the Inputs class with the simulation inputs
+ * @param num_lanes the number of Lanes of the segment
+ * @param length the number of sites of each Lane of the segment
+ */
+MacroSegment::MacroSegment(const Inputs &inputs, const int num_lanes, const int length) {
+    this->num_lanes = num_lanes;
+    this->max_speed = inputs.max_speed;
+    this->cell_length = getCellLength(inputs);
+    for (int site = 0; site < length; site += this->cell_length) {
+        this->cell_sizes.push_back(std::min(this->cell_length, length - site));
+    }
+    this->occupancies.assign(this->cell_sizes.size(), 0.0);
+    this->inflow_carry = 0.0;
+    this->pending_outflow = 0.0;
+
+    // Fractions of a cell the free flow and the backward wave cover in a step, and the capacity of a cell boundary
+    const double free_speed = std::max(0.0, inputs.max_speed - inputs.prob_slow_down);
+    const double wave_speed = std::max(0.0, 1.0 - inputs.prob_slow_down);
+    this->free_fraction = std::min(1.0, free_speed / this->cell_length);
+    this->wave_fraction = std::min(1.0, wave_speed / this->cell_length);
+    const double critical_density = free_speed + wave_speed > 0.0 ? wave_speed / (free_speed + wave_speed) : 0.0;
+    this->capacity = free_speed * critical_density * num_lanes;
+}
+
+/**
+ * Gets the number of sites of the cells of the model, which the free flowing Vehicles cross in about a step
+ * @param inputs instance of the Inputs class with the simulation inputs
+ * @return the length of the cells
+ */
+int MacroSegment::getCellLength(const Inputs &inputs) {
+    return std::max(1, inputs.max_speed);
+}
+
+/**
+ * Getter for the number of Vehicles in the segment
+ * @return the number of Vehicles
+ */
+int MacroSegment::getNumVehicles() const {
+    return static_cast<int>(this->records.size());
+}
+
+/**
+ * Gets the Vehicles a cell can send to the next one in a step, if it had room for them
+ * @param cell the number of the cell
+ * @return the sending flow of the cell
+ */
+double MacroSegment::getSending(const int cell) const {
+    return std::min(this->free_fraction * this->occupancies[cell], this->capacity);
+}
+
+/**
+ * Gets the Vehicles a cell can receive from the previous one in a step
+ * @param cell the number of the cell
+ * @return the receiving flow of the cell
+ */
+double MacroSegment::getReceiving(const int cell) const {
+    const double room = this->cell_sizes[cell] * this->num_lanes - this->occupancies[cell];
+    return std::max(0.0, std::min(this->capacity, this->wave_fraction * room));
+}
+
+/**
+ * Adds a Vehicle of the CA rules to the cell of its site when the segment switches to the model. The Vehicles must be
+ * added in order of decreasing position.
+ * @param site the site of the Vehicle
+ * @param record the record of the Vehicle, with its time on road
+ * @param time the simulation time
+ * @return 0 if successful, nonzero otherwise
+ */
+int MacroSegment::addVehicle(const int site, VehicleTransfer record, const int time) {
+    this->occupancies[site / this->cell_length] += 1.0;
+    record.time_on_road -= time;
+    this->records.push_back(record);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Moves the Vehicles waiting at the end of the links into the first cell, as many as it receives in a step, taking
+ * them from the Lanes in turn. The Vehicles get a new id from the segment, and the Vehicles still waiting spend the
+ * step on the road.
+ * @param waiting pointer to the Vehicles waiting at the end of the links, per Lane
+ * @param time the simulation time
+ * @param next_id_ptr pointer to the id of the next Vehicle of the segment
+ * @return 0 if successful, nonzero otherwise
+ */
+int MacroSegment::receive(std::vector<std::deque<VehicleTransfer> > *waiting, const int time, int *next_id_ptr) {
+    size_t num_waiting = 0;
+    for (const auto &lane_waiting: *waiting) {
+        num_waiting += lane_waiting.size();
+    }
+    if (num_waiting == 0) {
+        this->inflow_carry = 0.0;
+        return 0;
+    }
+    const double inflow = this->getReceiving(0) + this->inflow_carry;
+    const int num_entering = std::min(static_cast<int>(inflow), static_cast<int>(num_waiting));
+    this->inflow_carry = num_entering < static_cast<int>(num_waiting) ? inflow - num_entering : 0.0;
+
+    // Take the Vehicles from the Lanes in turn, from the right Lane
+    int num_entered = 0;
+    for (int i = 0; num_entered < num_entering; i = (i + 1) % this->num_lanes) {
+        std::deque<VehicleTransfer> &lane_waiting = (*waiting)[i];
+        if (lane_waiting.empty()) {
+            continue;
+        }
+        VehicleTransfer record = lane_waiting.front();
+        lane_waiting.pop_front();
+        record.origin_id = (*next_id_ptr)++;
+        record.time_on_road -= time;
+        this->records.push_back(record);
+        this->occupancies[0] += 1.0;
+        num_entered++;
+    }
+    for (auto &lane_waiting: *waiting) {
+        for (auto &transfer: lane_waiting) {
+            transfer.time_on_road++;
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step of the model: the flows between the cells and out of the last one follow from the occupancies
+ * at the start of the step, and the Vehicles flowing out of the last cell leave the segment at the maximum speed, a
+ * whole Vehicle once half of it flowed out, so that on average they leave when their occupancy does
+ * @param time the simulation time after the step
+ * @param departures pointer to the records of the Vehicles leaving the segment, with their time on road
+ * @return 0 if successful, nonzero otherwise
+ */
+int MacroSegment::step(const int time, std::vector<VehicleTransfer> *departures) {
+    const int num_cells = static_cast<int>(this->occupancies.size());
+    std::vector<double> flows(num_cells);
+    for (int i = 0; i < num_cells; i++) {
+        flows[i] = i + 1 < num_cells
+                       ? std::min(this->getSending(i), this->getReceiving(i + 1))
+                       : this->getSending(i);
+    }
+    for (int i = 0; i < num_cells; i++) {
+        this->occupancies[i] -= flows[i];
+        if (i + 1 < num_cells) {
+            this->occupancies[i + 1] += flows[i];
+        }
+    }
+
+    // The Vehicles leaving the last cell are the most downstream ones
+    this->pending_outflow += flows[num_cells - 1];
+    while (this->pending_outflow >= 0.5 && !this->records.empty()) {
+        VehicleTransfer record = this->records.front();
+        this->records.pop_front();
+        record.speed = this->max_speed;
+        record.time_on_road += time;
+        departures->push_back(record);
+        this->pending_outflow -= 1.0;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Gets the highest density of the stretches of consecutive cells of the segment
+ * @param window the number of cells of a stretch
+ * @return the largest number of Vehicles per site of a stretch
+ */
+double MacroSegment::getMaxDensity(const int window) const {
+    double max_density = 0.0;
+    for (size_t i = 0; i < this->occupancies.size(); i += window) {
+        double occupancy = 0.0;
+        int size = 0;
+        for (size_t j = i; j < std::min(i + window, this->occupancies.size()); j++) {
+            occupancy += this->occupancies[j];
+            size += this->cell_sizes[j];
+        }
+        max_density = std::max(max_density, occupancy / (size * this->num_lanes));
+    }
+    return max_density;
+}
+
+/**
+ * Empties the segment when it switches back to the CA rules. The Vehicles of the records are shared between the cells
+ * in proportion to their occupancies, from the last cell, within the sites of the cells, and the Vehicles of each cell
+ * are spread evenly over its sites and Lanes, with the speed their spacing allows. The placements are in order of
+ * decreasing position, matching the records of the Vehicles.
+ * @param time the simulation time
+ * @param placements pointer to the sites, Lanes, speeds and records of the Vehicles
+ * @return 0 if successful, nonzero otherwise
+ */
+int MacroSegment::unload(const int time, std::vector<VehiclePlacement> *placements) {
+    const int num_cells = static_cast<int>(this->occupancies.size());
+    const int num_vehicles = static_cast<int>(this->records.size());
+    double total_occupancy = 0.0;
+    for (const double occupancy: this->occupancies) {
+        total_occupancy += occupancy;
+    }
+
+    // Round the cumulative occupancy from the last cell, scaled to the Vehicles of the records, into whole Vehicles
+    std::vector<int> counts(num_cells, 0);
+    double cumulative_occupancy = 0.0;
+    int num_assigned = 0;
+    for (int i = num_cells - 1; i >= 0 && total_occupancy > 0.0; i--) {
+        cumulative_occupancy += this->occupancies[i];
+        const int target = static_cast<int>(std::lround(cumulative_occupancy * num_vehicles / total_occupancy));
+        counts[i] = std::clamp(target - num_assigned, 0, this->cell_sizes[i] * this->num_lanes);
+        num_assigned += counts[i];
+    }
+    for (int i = num_cells - 1; i >= 0 && num_assigned < num_vehicles; i--) {
+        const int extra = std::min(num_vehicles - num_assigned, this->cell_sizes[i] * this->num_lanes - counts[i]);
+        counts[i] += extra;
+        num_assigned += extra;
+    }
+
+    std::vector<VehiclePlacement> cell_placements;
+    for (int i = num_cells - 1; i >= 0; i--) {
+        const int cell_end = i * this->cell_length + this->cell_sizes[i];
+        cell_placements.clear();
+        for (int j = 0; j < this->num_lanes; j++) {
+            const int lane_count = counts[i] / this->num_lanes + (j < counts[i] % this->num_lanes ? 1 : 0);
+            if (lane_count == 0) {
+                continue;
+            }
+            const double spacing = static_cast<double>(this->cell_sizes[i]) / lane_count;
+            const int speed = std::clamp(static_cast<int>(spacing) - 1, 0, this->max_speed);
+            for (int k = 0; k < lane_count; k++) {
+                cell_placements.push_back({cell_end - 1 - static_cast<int>(k * spacing), j, speed, {}});
+            }
+        }
+        std::sort(cell_placements.begin(), cell_placements.end(), [](const auto &a, const auto &b) {
+            return a.site != b.site ? a.site > b.site : a.lane < b.lane;
+        });
+        for (auto &placement: cell_placements) {
+            placement.record = this->records.front();
+            placement.record.time_on_road += time;
+            this->records.pop_front();
+            placements->push_back(placement);
+        }
+        this->occupancies[i] = 0.0;
+    }
+    this->inflow_carry = 0.0;
+    this->pending_outflow = 0.0;
+
+    // Return with no errors
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_MACROSEGMENT_H
+#define CA_TRAFFIC_SIMULATION_MACROSEGMENT_H
+
+#include <deque>
+#include <vector>
+
+#include "Inputs.h"
+#include "RoadNetwork.h"
+
+/**
+ * Structure for a Vehicle placed back into the sites of a segment when it leaves the macroscopic model
+ */
+struct VehiclePlacement {
+    int site;
+    int lane;
+    int speed;
+    VehicleTransfer record;
+};
+
+/**
+ * Class for a segment of the road network simulated with the cell transmission model instead of the CA rules. The
+ * segment is divided into cells of the maximum speed in sites, each holding an occupancy of Vehicles over all its
+ * Lanes, and every step each cell sends to the next one as many Vehicles as the triangular fundamental diagram allows:
+ * the least of what the free flowing Vehicles of the cell cover in a step, the capacity, and the room left in the next
+ * cell behind the backward wave. The occupancies are fractional, so that the Vehicles keep their mean speed however
+ * sparse they are. Vehicles never overtake in the model, so their records (time on road and id) are kept in a single
+ * queue in position order, from which a whole Vehicle leaves the segment for each Vehicle that flowed out of the last
+ * cell, conserving the Vehicles.
+ */
+class MacroSegment {
+    int num_lanes;
+    int max_speed;
+    int cell_length;
+    std::vector<int> cell_sizes;
+    std::vector<double> occupancies;
+    double inflow_carry;
+    double pending_outflow;
+    double free_fraction;
+    double wave_fraction;
+    double capacity;
+    std::deque<VehicleTransfer> records;
+
+    [[nodiscard]] double getSending(int cell) const;
+
+    [[nodiscard]] double getReceiving(int cell) const;
+
+public:
+    MacroSegment(const Inputs &inputs, int num_lanes, int length);
+
+    [[nodiscard]] static int getCellLength(const Inputs &inputs);
+
+    [[nodiscard]] int getNumVehicles() const;
+
+    int addVehicle(int site, VehicleTransfer record, int time);
+
+    int receive(std::vector<std::deque<VehicleTransfer> > *waiting, int time, int *next_id_ptr);
+
+    int step(int time, std::vector<VehicleTransfer> *departures);
+
+    [[nodiscard]] double getMaxDensity(int window) const;
+
+    int unload(int time, std::vector<VehiclePlacement> *placements);
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_MACROSEGMENT_H
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <cstdlib>
+#include <algorithm>
+
+#include "MultiSpinEngine.h"
+
+/**
+ * Constructor for the MultiSpinEngine
+ * @param inputs instance of the Inputs class with simulation inputs
+ * @param process_data Contains the rank and size of the MPI process, represented
+ *                     by an instance of the `ProcessData` class. This is used to
+ *                     manage distributed simulation across multiple processes.
+ */
+MultiSpinEngine::MultiSpinEngine(const Inputs &inputs, const ProcessData &process_data) : random(inputs) {
+    // Split the sites among the processes in the same way as the Lane class, with the remainder on the last process
+    this->size = inputs.length / process_data.getSize();
+    if (process_data.getRank() == process_data.getSize() - 1) {
+        this->size += inputs.length % process_data.getSize();
+    }
+
+    // Copy the parameters of the CA rules
+    this->num_lanes = inputs.num_lanes;
+    this->max_speed = inputs.max_speed;
+    this->stride = this->max_speed + 1;
+    this->num_threads = std::max(1, std::min(inputs.num_threads, this->num_lanes));
+    this->num_vehicles = 0;
+
+    // Truncate the slow down probability to the 64 binary digits used to build the slow down masks, all ones if it is
+    // certain
+    this->slow_down_digits = 0;
+    double fraction = std::max(0.0, inputs.prob_slow_down);
+    for (int b = 63; b >= 0 && fraction < 1.0; b--) {
+        fraction *= 2.0;
+        if (fraction >= 1.0) {
+            this->slow_down_digits |= uint64_t{1} << b;
+            fraction -= 1.0;
+        }
+    }
+    if (fraction >= 1.0) {
+        this->slow_down_digits = ~uint64_t{0};
+    }
+
+    // Allocate the cell arrays of the Lanes, with all sites initially empty, each first written by the thread that
+    // updates its Lane so that its pages are placed on the NUMA node of that thread
+    this->huge_pages = inputs.huge_pages;
+    this->cells.resize(this->num_lanes, LaneVector<uint64_t>(LaneAllocator<uint64_t>(this->huge_pages)));
+    this->next_cells.resize(this->num_lanes, LaneVector<uint64_t>(LaneAllocator<uint64_t>(this->huge_pages)));
+#pragma omp parallel for schedule(static) num_threads(this->num_threads)
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->cells[i].assign(static_cast<size_t>(this->size) * this->stride, 0);
+        this->next_cells[i].assign(static_cast<size_t>(this->size) * this->stride, 0);
+    }
+
+    // Create a random number generator per Lane, seeded from the seed of the simulation when it has one so that its
+    // streams are reproduced
+    for (int i = 0; i < this->num_lanes; i++) {
+        if (this->random.isEnabled()) {
+            this->generators.emplace_back(KeyedRandom::mix(inputs.seed ^ KeyedRandom::mix(i)));
+        } else {
+            this->generators.emplace_back(static_cast<unsigned int>(std::rand()));
+        }
+    }
+    this->num_wrapped.resize(this->num_lanes, std::array<long, NUM_REPLICAS>{});
+}
+
+/**
+ * Draws a random slow down mask, each bit of which is set with the slow down probability
+ * @param generator the random number generator
+ * @return the slow down mask
+ */
+uint64_t MultiSpinEngine::drawSlowDownMask(std::mt19937_64 &generator) const {
+    if (this->slow_down_digits == 0) {
+        return 0;
+    }
+
+    // Compare the random numbers with the probability digit by digit, a bit being decided at the first digit where its
+    // random digit differs, set if the random digit is the smaller one. The bits still undecided after the last nonzero
+    // digit of the probability are not set.
+    uint64_t mask = 0;
+    uint64_t undecided = ~uint64_t{0};
+    for (int b = 63; b >= __builtin_ctzll(this->slow_down_digits) && undecided != 0; b--) {
+        const uint64_t word = generator();
+        if ((this->slow_down_digits >> b) & 1u) {
+            mask |= undecided & ~word;
+            undecided &= word;
+        } else {
+            undecided &= ~word;
+        }
+    }
+    return mask;
+}
+
+/**
+ * Populates every replica of the ring road with its fixed number of Vehicles in the same way as the Road class, placed
+ * in random distinct sites and initially stopped
+ * @param percent_full the fraction of the sites of the Road that are occupied
+ * @return 0 if successful, nonzero otherwise
+ */
+int MultiSpinEngine::populate(const double percent_full) {
+    const int num_sites = this->num_lanes * this->size;
+    this->num_vehicles = std::min(num_sites, static_cast<int>(num_sites * percent_full + 0.5));
+
+    // Draw the occupied sites of each replica with a partial Fisher-Yates shuffle of all the sites of the Road
+    std::vector<int> sites(num_sites);
+    for (int r = 0; r < NUM_REPLICAS; r++) {
+        for (int i = 0; i < num_sites; i++) {
+            sites[i] = i;
+        }
+        for (int i = 0; i < this->num_vehicles; i++) {
+            const int pick = this->random.isEnabled() ? this->random.drawIndex(r, i, STREAM_POPULATE, num_sites - i)
+                                                      : std::rand() % (num_sites - i);
+            std::swap(sites[i], sites[i + pick]);
+            const int lane = sites[i] / this->size;
+            const int site = sites[i] % this->size;
+            this->cells[lane][static_cast<size_t>(site) * this->stride] |= uint64_t{1} << r;
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs the lane moves of a time step in all the replicas, with the Lanes updated in parallel. A Vehicle accelerates,
+ * brakes to the number of empty sites ahead of it, randomly slows down and moves by its speed, continuing from the
+ * start of the Lane when it passes the end.
+ * @return 0 if successful, nonzero otherwise
+ */
+int MultiSpinEngine::step() {
+    const int max_speed = this->max_speed;
+    const int stride = this->stride;
+    const int size = this->size;
+
+#pragma omp parallel for schedule(static) num_threads(this->num_threads)
+    for (int i = 0; i < this->num_lanes; i++) {
+        const uint64_t *lane_cells = this->cells[i].data();
+        uint64_t *lane_next_cells = this->next_cells[i].data();
+        std::fill(this->next_cells[i].begin(), this->next_cells[i].end(), 0);
+
+        // Speed words of the Vehicles of a site being updated, the word 0 being the occupancy word
+        std::vector<uint64_t> speeds(max_speed + 2, 0);
+
+        for (int site = 0; site < size; site++) {
+            const uint64_t *site_cells = lane_cells + static_cast<size_t>(site) * stride;
+            if (site_cells[0] == 0) {
+                continue;
+            }
+
+            // Accelerate, raising the speed of each Vehicle below the maximum speed by one
+            speeds[0] = site_cells[0];
+            for (int k = 1; k <= max_speed; k++) {
+                speeds[k] = site_cells[k - 1];
+            }
+
+            // Brake to the number of empty sites ahead
+            uint64_t empty = ~uint64_t{0};
+            for (int k = 1; k <= max_speed; k++) {
+                int ahead = site + k;
+                while (ahead >= size) {
+                    ahead -= size;
+                }
+                empty &= ~lane_cells[static_cast<size_t>(ahead) * stride];
+                speeds[k] &= empty;
+            }
+
+            // Randomly slow down the moving Vehicles by one
+            if (speeds[1] != 0) {
+                const uint64_t slow_down = this->drawSlowDownMask(this->generators[i]);
+                for (int k = 1; k <= max_speed; k++) {
+                    speeds[k] = (speeds[k] & ~slow_down) | (speeds[k + 1] & slow_down);
+                }
+            }
+
+            // Move the Vehicles with each speed, counting the ones passing the end of the Lane in each replica
+            for (int v = 0; v <= max_speed; v++) {
+                const uint64_t moving = speeds[v] & ~speeds[v + 1];
+                if (moving == 0) {
+                    continue;
+                }
+                int new_site = site + v;
+                if (new_site >= size) {
+                    for (uint64_t bits = moving; bits != 0; bits &= bits - 1) {
+                        this->num_wrapped[i][__builtin_ctzll(bits)]++;
+                    }
+                    while (new_site >= size) {
+                        new_site -= size;
+                    }
+                }
+                uint64_t *new_site_cells = lane_next_cells + static_cast<size_t>(new_site) * stride;
+                for (int k = 0; k <= v; k++) {
+                    new_site_cells[k] |= moving;
+                }
+            }
+        }
+
+        this->cells[i].swap(this->next_cells[i]);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Counts the Vehicles that passed the end of their Lane in a replica since the start of the simulation
+ * @param replica the number of the replica
+ * @return the number of Vehicles that passed the end of their Lane
+ */
+long MultiSpinEngine::getNumWrapped(const int replica) const {
+    long count = 0;
+    for (const auto &lane_num_wrapped: this->num_wrapped) {
+        count += lane_num_wrapped[replica];
+    }
+    return count;
+}
+
+/**
+ * Sums the positions of all the Vehicles of a replica
+ * @param replica the number of the replica
+ * @return the sum of the positions
+ */
+long MultiSpinEngine::getPositionSum(const int replica) const {
+    long sum = 0;
+    for (const auto &lane_cells: this->cells) {
+        for (int site = 0; site < this->size; site++) {
+            if ((lane_cells[static_cast<size_t>(site) * this->stride] >> replica) & 1u) {
+                sum += site;
+            }
+        }
+    }
+    return sum;
+}
+
+/**
+ * Starts measuring the flow and mean speed of the replicas from the current configuration, at the end of the warmup
+ * @return 0 if successful, nonzero otherwise
+ */
+int MultiSpinEngine::startMeasurement() {
+    for (int r = 0; r < NUM_REPLICAS; r++) {
+        this->start_num_wrapped[r] = this->getNumWrapped(r);
+        this->start_position_sums[r] = this->getPositionSum(r);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Computes the average flow of a replica since the start of the measurement
+ * @param replica the number of the replica
+ * @param num_steps the number of steps since the start of the measurement
+ * @return the flow, in Vehicles per step per Lane passing the end of the Lanes
+ */
+double MultiSpinEngine::getFlow(const int replica, const int num_steps) const {
+    return static_cast<double>(this->getNumWrapped(replica) - this->start_num_wrapped[replica]) /
+           (static_cast<double>(num_steps) * this->num_lanes);
+}
+
+/**
+ * Computes the average speed of the Vehicles of a replica since the start of the measurement, from the distance they
+ * travelled, i.e. a Lane length for each pass of the end of a Lane plus the change of their positions
+ * @param replica the number of the replica
+ * @param num_steps the number of steps since the start of the measurement
+ * @return the mean speed, in sites per step
+ */
+double MultiSpinEngine::getMeanSpeed(const int replica, const int num_steps) const {
+    const long distance = (this->getNumWrapped(replica) - this->start_num_wrapped[replica]) * this->size +
+                          this->getPositionSum(replica) - this->start_position_sums[replica];
+    return static_cast<double>(distance) / (static_cast<double>(num_steps) * this->num_vehicles);
+}
+
+/**
+ * Prints the NUMA locality of the cell arrays of the Lanes for the threads updating them, and their huge pages
+ * @return 0 if successful, nonzero otherwise
+ */
+int MultiSpinEngine::printMemoryLocality() const {
+    std::vector<std::vector<std::pair<const void *, size_t> > > lane_arrays(this->num_lanes);
+    for (int i = 0; i < this->num_lanes; i++) {
+        lane_arrays[i] = {
+            {this->cells[i].data(), this->cells[i].size() * sizeof(uint64_t)},
+            {this->next_cells[i].data(), this->next_cells[i].size() * sizeof(uint64_t)}
+        };
+    }
+    return ::printMemoryLocality(lane_arrays, this->num_threads, this->huge_pages);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_MULTISPINENGINE_H
+#define CA_TRAFFIC_SIMULATION_MULTISPINENGINE_H
+
+#include <vector>
+#include <array>
+#include <random>
+#include <cstdint>
+
+#include "Inputs.h"
+#include "ProcessData.h"
+#include "KeyedRandom.h"
+#include "LaneMemory.h"
+
+/**
+ * Class for the multi-spin coded step engine, which simulates 64 independent replicas of the ring road at once with
+ * the single lane (Nagel-Schreckenberg) rules, each Lane being a separate ring without lane switches. Bit r of every
+ * word of the cell arrays belongs to the replica r. Each site stores an occupancy word followed by max_speed speed
+ * words in unary code, the word k having the bits of the replicas whose Vehicle in the site has a speed of at least k,
+ * so that the acceleration, the braking to the gap and the random slow down are shifts and masks of whole words.
+ *
+ * The random slow down masks compare 64 bit-sliced uniform random numbers with the binary digits of the slow down
+ * probability, drawing one random word per digit from the most significant one until every bit is decided, which
+ * takes about eight words per mask.
+ */
+class MultiSpinEngine {
+public:
+    static constexpr int NUM_REPLICAS = 64;
+
+private:
+    int num_lanes;
+    int size;
+    int max_speed;
+    int stride;
+    int num_threads;
+    uint64_t slow_down_digits;
+    int num_vehicles;
+    int huge_pages;
+    std::vector<LaneVector<uint64_t> > cells;
+    std::vector<LaneVector<uint64_t> > next_cells;
+    std::vector<std::mt19937_64> generators;
+    KeyedRandom random;
+    std::vector<std::array<long, NUM_REPLICAS> > num_wrapped;
+    std::array<long, NUM_REPLICAS> start_num_wrapped{};
+    std::array<long, NUM_REPLICAS> start_position_sums{};
+
+    uint64_t drawSlowDownMask(std::mt19937_64 &generator) const;
+
+    [[nodiscard]] long getNumWrapped(int replica) const;
+
+    [[nodiscard]] long getPositionSum(int replica) const;
+
+public:
+    MultiSpinEngine(const Inputs &inputs, const ProcessData &process_data);
+
+    ~MultiSpinEngine() = default;
+
+    int populate(double percent_full);
+
+    int step();
+
+    int startMeasurement();
+
+    [[nodiscard]] double getFlow(int replica, int num_steps) const;
+
+    [[nodiscard]] double getMeanSpeed(int replica, int num_steps) const;
+
+    int printMemoryLocality() const;
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_MULTISPINENGINE_H
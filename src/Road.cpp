@@ -2,9 +2,14 @@
  * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
  */
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "Road.h"
+#include "Vehicle.h"
 #include "Inputs.h"
 #include "ProcessData.h"
+#include "KeyedRandom.h"
 
 /**
  * Constructor for the Road
@@ -17,18 +22,30 @@ Road::Road(const Inputs &inputs, const ProcessData &process_data) {
 #ifdef DEBUG
     std::cout << "creating new road with " << inputs.num_lanes << " lanes..." << std::endl;
 #endif
+    // Create the demand of Vehicles entering the Road, which schedules the spawns of the Lanes
+    this->demand = new Demand(inputs);
+
+    // The lane switches are proposed, resolved and committed by Lane, in parallel with more than one thread. Without a
+    // seed the Vehicles draw their lane switches from the sequence of std::rand, whose order would then depend on the
+    // timing of the threads, so they are proposed on a single thread
+    this->num_threads = inputs.seed != 0 ? std::max(1, std::min(inputs.num_threads, inputs.num_lanes)) : 1;
+
     // Create the Lane objects for the Road
     for (int i = 0; i < inputs.num_lanes; i++) {
-        this->lanes.push_back(new Lane(inputs, i, process_data));
+        this->lanes.push_back(new Lane(inputs, i, process_data, *this->demand));
+    }
+
+    // Resolve the right (lower numbered) and left (higher numbered) neighbour of each Lane once, with a null pointer
+    // for the sides at the edges of the Road
+    for (int i = 0; i < inputs.num_lanes; i++) {
+        this->neighbour_lanes.push_back({
+            i > 0 ? this->lanes[i - 1] : nullptr,
+            i < inputs.num_lanes - 1 ? this->lanes[i + 1] : nullptr
+        });
     }
 #ifdef DEBUG
     std::cout << "done creating road" << std::endl;
 #endif
-
-    this->interarrival_time_cdf = new CDF();
-    if (const int status = this->interarrival_time_cdf->read_cdf("interarrival-cdf.dat"); status != 0) {
-        throw std::exception();
-    }
 }
 
 /**
@@ -39,26 +56,167 @@ Road::~Road() {
     for (const auto &lane: this->lanes) {
         delete lane;
     }
+
+    // Delete the demand of the Road
+    delete this->demand;
 }
 
 /**
  * Getter for the Lanes of the road
  * @return
  */
-std::vector<Lane *> Road::getLanes() {
+const std::vector<Lane *> &Road::getLanes() const {
     return this->lanes;
 }
 
+/**
+ * Getter for the neighbour Lanes of a Lane of the Road
+ * @param lane_num the number of the Lane
+ * @return the right and left neighbour Lanes, null if the Lane is at that edge of the Road
+ */
+const std::array<Lane *, 2> &Road::getNeighbourLanes(const int lane_num) const {
+    return this->neighbour_lanes[lane_num];
+}
+
 /**
  * Attempts to spawn Vehicles on each Lane of the Road
  * @param inputs instance of the Inputs class with the simulation Inputs
+ * @param time the simulation time
  * @param vehicles pointer to the array of Vehicles that exist
  * @param next_id_ptr pointer to the id of the next spawned Vehicle
  * @return 0 if successful, nonzero otherwise
  */
-int Road::attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const {
+int Road::attemptSpawn(const Inputs &inputs, const int time, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const {
+    for (const auto lane: this->lanes) {
+        lane->attemptSpawn(inputs, time, vehicles, next_id_ptr, this->demand);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs the lane switches of all the Vehicles in three phases over the Lanes, separated by barriers: each Lane
+ * proposes the switches of its Vehicles from the unchanged Road, then resolves the proposals into it from its
+ * neighbours, where the Vehicle from the lower numbered Lane has priority for a site targeted from both sides, and
+ * finally commits its departures and arrivals in bulk. Each phase only writes the Lane and the Vehicles it handles, so
+ * the switches do not depend on the order of the Vehicles and the Lanes are updated in parallel.
+ * @return 0 if successful, nonzero otherwise
+ */
+int Road::switchLanes() const {
+    const int num_lanes = static_cast<int>(this->lanes.size());
+    int status = 0;
+
+#pragma omp parallel num_threads(this->num_threads)
+    {
+#pragma omp for schedule(static)
+        for (int i = 0; i < num_lanes; i++) {
+            this->lanes[i]->proposeLaneSwitches(this);
+        }
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < num_lanes; i++) {
+            this->lanes[i]->resolveLaneSwitches(this);
+        }
+
+#pragma omp for schedule(static) reduction(|:status)
+        for (int i = 0; i < num_lanes; i++) {
+            status |= this->lanes[i]->commitLaneSwitches();
+        }
+    }
+
+    return status;
+}
+
+/**
+ * Removes the Vehicles that left the Road from the ordered Vehicles of each Lane
+ * @return 0 if successful, nonzero otherwise
+ */
+int Road::removeExitedVehicles() const {
+    for (const auto lane: this->lanes) {
+        lane->removeExitedVehicles();
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Removes all the Vehicles from the Lanes of the Road, without deleting them
+ * @return 0 if successful, nonzero otherwise
+ */
+int Road::clearVehicles() const {
+    for (const auto lane: this->lanes) {
+        lane->clearVehicles();
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Moves the Vehicles that wrapped around to the start of their Lane on a ring road into the position order of the Lane
+ * @return the number of Vehicles that wrapped around in all the Lanes
+ */
+int Road::rotateWrappedVehicles() const {
+    int num_wrapped = 0;
+    for (const auto lane: this->lanes) {
+        num_wrapped += lane->rotateWrappedVehicles();
+    }
+    return num_wrapped;
+}
+
+/**
+ * Populates the ring road with its fixed number of Vehicles, the fraction of full of all the sites, placed in random
+ * distinct sites and initially stopped
+ * @param inputs instance of the Inputs class with the simulation Inputs
+ * @param vehicles pointer to the array of Vehicles to add the placed Vehicles to
+ * @param next_id_ptr pointer to the id of the next placed Vehicle
+ * @return 0 if successful, nonzero otherwise
+ */
+int Road::populate(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const {
+    const int size = this->lanes[0]->getSize();
+    const int num_sites = static_cast<int>(this->lanes.size()) * size;
+    const int num_vehicles = std::min(num_sites, static_cast<int>(num_sites * inputs.percent_full + 0.5));
+
+    // Draw the occupied sites with a partial Fisher-Yates shuffle of all the sites of the Road
+    std::vector<int> sites(num_sites);
+    for (int i = 0; i < num_sites; i++) {
+        sites[i] = i;
+    }
+    const KeyedRandom random(inputs);
+    for (int i = 0; i < num_vehicles; i++) {
+        const int pick = random.isEnabled() ? random.drawIndex(0, i, STREAM_POPULATE, num_sites - i)
+                                            : std::rand() % (num_sites - i);
+        std::swap(sites[i], sites[i + pick]);
+    }
+
+    // Place the Vehicles Lane after Lane in order of decreasing position
+    std::sort(sites.begin(), sites.begin() + num_vehicles, [size](const int a, const int b) {
+        return a / size != b / size ? a / size < b / size : a % size > b % size;
+    });
+    for (int i = 0; i < num_vehicles; i++) {
+        Lane *lane = this->lanes[sites[i] / size];
+        vehicles->push_back(new Vehicle(lane, (*next_id_ptr)++, sites[i] % size, inputs, 0));
+        vehicles->back()->setSpeed(0);
+        lane->placeVehicle(vehicles->back());
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Collects the Vehicles of the Road ordered by position, Lane after Lane and starting with the most downstream Vehicle
+ * of each Lane
+ * @param ordered_vehicles pointer to the list to fill with the ordered Vehicles
+ * @return 0 if successful, nonzero otherwise
+ */
+int Road::getOrderedVehicles(std::vector<Vehicle *> *ordered_vehicles) const {
+    ordered_vehicles->clear();
     for (const auto lane: this->lanes) {
-        lane->attemptSpawn(inputs, vehicles, next_id_ptr, this->interarrival_time_cdf);
+        ordered_vehicles->insert(ordered_vehicles->end(), lane->getOrderedVehicles().begin(),
+                                 lane->getOrderedVehicles().end());
     }
 
     // Return with no errors
@@ -6,10 +6,11 @@
 #define CA_TRAFFIC_SIMULATION_ROAD_H
 
 #include <vector>
+#include <array>
 
 #include "Lane.h"
 #include "Inputs.h"
-#include "CDF.h"
+#include "Demand.h"
 #include "ProcessData.h"
 
 /**
@@ -18,16 +19,32 @@
  */
 class Road {
     std::vector<Lane *> lanes;
-    CDF *interarrival_time_cdf;
+    std::vector<std::array<Lane *, 2> > neighbour_lanes;
+    Demand *demand;
+    int num_threads;
 
 public:
     Road(const Inputs &inputs, const ProcessData &process_data);
 
     ~Road();
 
-    std::vector<Lane *> getLanes();
+    [[nodiscard]] const std::vector<Lane *> &getLanes() const;
 
-    int attemptSpawn(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const;
+    [[nodiscard]] const std::array<Lane *, 2> &getNeighbourLanes(int lane_num) const;
+
+    int attemptSpawn(const Inputs &inputs, int time, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const;
+
+    int switchLanes() const;
+
+    int removeExitedVehicles() const;
+
+    int clearVehicles() const;
+
+    [[nodiscard]] int rotateWrappedVehicles() const;
+
+    int populate(const Inputs &inputs, std::vector<Vehicle *> *vehicles, int *next_id_ptr) const;
+
+    int getOrderedVehicles(std::vector<Vehicle *> *ordered_vehicles) const;
 
 #ifdef DEBUG
     void printRoad() const;
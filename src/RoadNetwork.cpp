@@ -0,0 +1,773 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "RoadNetwork.h"
+#include "Lane.h"
+#include "MacroSegment.h"
+#include "Vehicle.h"
+
+// Number of integers of a packed Vehicle transfer, and of a packed exit from the network
+constexpr int TRANSFER_SIZE = 6;
+constexpr int EXIT_SIZE = 2;
+
+/**
+ * Constructor for the RoadNetwork, which reads the network, partitions its segments between the processes and creates
+ * the Roads of the segments of the process
+ * @param inputs instance of the Inputs class with the simulation inputs, shared by all the segments
+ * @param process_data the rank and size of the MPI process
+ */
+RoadNetwork::RoadNetwork(const Inputs &inputs, const ProcessData &process_data) {
+    this->rank = process_data.getRank();
+    this->num_processes = process_data.getSize();
+    this->traversal_order = inputs.traversal_order;
+    this->macro_density = inputs.macro_density;
+    this->time = 0;
+    this->num_transfers = 0;
+    this->num_remote_transfers = 0;
+    this->num_mode_switches = 0;
+    this->num_macro_steps = 0;
+    this->num_segment_steps = 0;
+
+    // Read the network and assign its segments to the processes, which all find the same partition
+    if (const int status = this->readNetwork("road-network.dat"); status != 0) {
+        throw std::exception();
+    }
+    this->partitionSegments();
+
+    // Each segment follows the inputs with its own Lanes, sites and seed, so that its random numbers are its own
+    const int num_segments = static_cast<int>(this->segments.size());
+    for (int s = 0; s < num_segments; s++) {
+        Inputs segment_inputs = inputs;
+        segment_inputs.num_lanes = this->segments[s].num_lanes;
+        segment_inputs.length = this->segments[s].length;
+        if (inputs.seed != 0) {
+            segment_inputs.seed = KeyedRandom::mix(inputs.seed ^ (static_cast<uint64_t>(s + 1) << 40));
+        }
+        this->segment_inputs.push_back(segment_inputs);
+        this->segment_randoms.emplace_back(segment_inputs);
+    }
+
+    // Create the Roads of the segments of the process, each on its own as if run by a single process
+    this->roads.assign(num_segments, nullptr);
+    this->vehicles.resize(num_segments);
+    this->next_ids.assign(num_segments, 0);
+    this->waiting_vehicles.resize(num_segments);
+    this->macro_segments.assign(num_segments, nullptr);
+    for (int s = 0; s < num_segments; s++) {
+        if (this->owners[s] == this->rank) {
+            this->roads[s] = new Road(this->segment_inputs[s], ProcessData(0, 1));
+            this->waiting_vehicles[s].resize(this->segments[s].num_lanes);
+        }
+    }
+}
+
+/**
+ * Destructor of the RoadNetwork
+ */
+RoadNetwork::~RoadNetwork() {
+    for (const auto &road: this->roads) {
+        delete road;
+    }
+    for (const auto &macro_segment: this->macro_segments) {
+        delete macro_segment;
+    }
+    for (const auto &segment_vehicles: this->vehicles) {
+        for (const auto &vehicle: segment_vehicles) {
+            delete vehicle;
+        }
+    }
+}
+
+/**
+ * Reads the segments and links of the network from a text file, one per line with comma separated fields:
+ * "segment,<name>,<number of lanes>,<number of sites>,<1 if Vehicles enter it from the demand, 0 otherwise>" and
+ * "link,<name of the segment it leaves>,<name of the segment it enters>,<share of the Vehicles leaving the segment>"
+ * @param file_name path and name of the network file
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::readNetwork(const std::string &file_name) {
+    std::ifstream file(file_name);
+    if (!file) {
+        std::cout << "error: failure to open \"" << file_name << "\" file!" << std::endl;
+        return 1;
+    }
+    std::vector<std::vector<std::string> > link_lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream line_stream(line);
+        std::string field;
+        while (std::getline(line_stream, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields[0] == "segment" && fields.size() == 5) {
+            this->segments.push_back({
+                fields[1], std::stoi(fields[2]), std::stoi(fields[3]), std::stoi(fields[4]) != 0
+            });
+            if (this->segments.back().num_lanes < 1 || this->segments.back().length < 1) {
+                std::cout << "error: the segment " << fields[1] << " needs at least one lane and one site!"
+                        << std::endl;
+                return 1;
+            }
+        } else if (fields[0] == "link" && fields.size() == 4) {
+            link_lines.push_back(fields);
+        } else {
+            std::cout << "error: \"" << line << "\" is neither a segment nor a link of the network!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Resolve the segments of the links by name
+    const auto find_segment = [&](const std::string &name) {
+        for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+            if (this->segments[s].name == name) {
+                return s;
+            }
+        }
+        return -1;
+    };
+    this->outgoing_links.resize(this->segments.size());
+    for (const auto &fields: link_lines) {
+        const int from = find_segment(fields[1]);
+        const int to = find_segment(fields[2]);
+        const double share = std::stod(fields[3]);
+        if (from < 0 || to < 0 || share < 0.0) {
+            std::cout << "error: the link " << fields[1] << " -> " << fields[2] << " needs known segments and a share "
+                    << "of at least 0!" << std::endl;
+            return 1;
+        }
+        this->outgoing_links[from].push_back(static_cast<int>(this->links.size()));
+        this->links.push_back({from, to, share});
+    }
+
+    // Vehicles enter the network somewhere, and each segment with links sends its Vehicles into one of them
+    if (std::none_of(this->segments.begin(), this->segments.end(), [](const NetworkSegment &segment) {
+        return segment.entry;
+    })) {
+        std::cout << "error: the network has no entry segment!" << std::endl;
+        return 1;
+    }
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        double total_share = 0.0;
+        for (const int link: this->outgoing_links[s]) {
+            total_share += this->links[link].share;
+        }
+        if (!this->outgoing_links[s].empty() && total_share <= 0.0) {
+            std::cout << "error: the shares of the links leaving the segment " << this->segments[s].name
+                    << " must not all be zero!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Assigns the segments of the network to the processes, balancing their cells (sites of all the Lanes) while cutting
+ * few links, since every Vehicle crossing a cut link is sent to another process. The segments are ordered by a breadth
+ * first search from the entries, so that linked segments are close in the order, and the order is split into runs of
+ * about equal cells. The partition is then refined by moving each segment to the process of its linked segments when
+ * that cuts fewer links without loading the process beyond its share by more than the allowed imbalance. The partition
+ * only depends on the network, so all the processes find the same one.
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::partitionSegments() {
+    const int num_segments = static_cast<int>(this->segments.size());
+    std::vector<long> cells(num_segments);
+    long total_cells = 0;
+    for (int s = 0; s < num_segments; s++) {
+        cells[s] = static_cast<long>(this->segments[s].num_lanes) * this->segments[s].length;
+        total_cells += cells[s];
+    }
+    std::vector<std::vector<int> > neighbours(num_segments);
+    for (const auto &link: this->links) {
+        neighbours[link.from].push_back(link.to);
+        neighbours[link.to].push_back(link.from);
+    }
+
+    // Order the segments breadth first from the entries, then from any segment not reached from them
+    std::vector<int> order;
+    std::vector<bool> visited(num_segments, false);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int root = 0; root < num_segments; root++) {
+            if (visited[root] || (pass == 0 && !this->segments[root].entry)) {
+                continue;
+            }
+            visited[root] = true;
+            order.push_back(root);
+            for (size_t next = order.size() - 1; next < order.size(); next++) {
+                for (const int neighbour: neighbours[order[next]]) {
+                    if (!visited[neighbour]) {
+                        visited[neighbour] = true;
+                        order.push_back(neighbour);
+                    }
+                }
+            }
+        }
+    }
+
+    // Split the order into runs of about equal cells, each segment going to the run holding its middle cell
+    this->owners.assign(num_segments, 0);
+    std::vector<long> loads(this->num_processes, 0);
+    std::vector<int> num_owned(this->num_processes, 0);
+    long cumulative_cells = 0;
+    for (const int s: order) {
+        this->owners[s] = static_cast<int>(std::min<long>(this->num_processes - 1,
+                                                          (2 * cumulative_cells + cells[s]) * this->num_processes /
+                                                          (2 * total_cells)));
+        cumulative_cells += cells[s];
+        loads[this->owners[s]] += cells[s];
+        num_owned[this->owners[s]]++;
+    }
+
+    // Move the segments to the process they have the most links to, while it cuts fewer links and keeps the balance
+    const double max_load = (1.0 + PARTITION_IMBALANCE) * static_cast<double>(total_cells) / this->num_processes;
+    std::vector<int> num_links(this->num_processes, 0);
+    bool moved = true;
+    for (int pass = 0; pass < num_segments && moved; pass++) {
+        moved = false;
+        for (const int s: order) {
+            const int owner = this->owners[s];
+            for (const int neighbour: neighbours[s]) {
+                num_links[this->owners[neighbour]]++;
+            }
+            int best = owner;
+            for (const int neighbour: neighbours[s]) {
+                const int q = this->owners[neighbour];
+                if (num_links[q] > num_links[best] && num_owned[owner] > 1 &&
+                    static_cast<double>(loads[q] + cells[s]) <= max_load) {
+                    best = q;
+                }
+            }
+            for (const int neighbour: neighbours[s]) {
+                num_links[this->owners[neighbour]] = 0;
+            }
+            if (best != owner) {
+                this->owners[s] = best;
+                loads[owner] -= cells[s];
+                loads[best] += cells[s];
+                num_owned[owner]--;
+                num_owned[best]++;
+                moved = true;
+            }
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Selects the link a Vehicle leaving the end of a segment takes from the shares of the links of the segment, keyed by
+ * the id and age of the Vehicle when the simulation has a seed
+ * @param segment the number of the segment the Vehicle leaves
+ * @param id the id of the Vehicle in the segment
+ * @param time_on_road the number of steps the Vehicle spent on the network
+ * @return the number of the link
+ */
+int RoadNetwork::selectLink(const int segment, const int id, const int time_on_road) const {
+    const std::vector<int> &candidates = this->outgoing_links[segment];
+    if (candidates.size() == 1) {
+        return candidates[0];
+    }
+    const KeyedRandom &random = this->segment_randoms[segment];
+    const double u = random.isEnabled()
+                         ? random.draw(id, time_on_road, STREAM_ROUTE)
+                         : static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+    double total_share = 0.0;
+    for (const int link: candidates) {
+        total_share += this->links[link].share;
+    }
+    double cumulative_share = 0.0;
+    for (size_t i = 0; i + 1 < candidates.size(); i++) {
+        cumulative_share += this->links[candidates[i]].share;
+        if (u * total_share < cumulative_share) {
+            return candidates[i];
+        }
+    }
+    return candidates.back();
+}
+
+/**
+ * Packs a Vehicle leaving the end of a segment for the process of the segment its link enters, keeping its Lane as far
+ * as the next segment has it, or as an exit from the network if the segment has no links
+ * @param segment the number of the segment the Vehicle leaves
+ * @param departure the Lane, speed, time on road and id of the Vehicle
+ * @param transfers pointer to the packed Vehicle transfers for each process
+ * @param exits pointer to the packed exits from the network
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::sendVehicle(const int segment, const VehicleTransfer &departure,
+                             std::vector<std::vector<int> > *transfers, std::vector<int> *exits) {
+    if (this->outgoing_links[segment].empty()) {
+        exits->insert(exits->end(), {segment, departure.time_on_road});
+        return 0;
+    }
+    const int next_segment = this->links[this->selectLink(segment, departure.origin_id, departure.time_on_road)].to;
+    const int lane = std::min(departure.lane, this->segments[next_segment].num_lanes - 1);
+    std::vector<int> &buffer = (*transfers)[this->owners[next_segment]];
+    buffer.insert(buffer.end(), {
+                      next_segment, lane, departure.speed, departure.time_on_road, segment, departure.origin_id
+                  });
+    this->num_transfers++;
+    if (this->owners[next_segment] != this->rank) {
+        this->num_remote_transfers++;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step on a segment of the process with the rules of the reference engine. The Vehicles leaving the
+ * end of the segment are sent into their links and deleted.
+ * @param segment the number of the segment
+ * @param transfers pointer to the packed Vehicle transfers for each process
+ * @param exits pointer to the packed exits from the network
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::stepSegment(const int segment, std::vector<std::vector<int> > *transfers, std::vector<int> *exits) {
+    Road *road_ptr = this->roads[segment];
+    std::vector<Vehicle *> &segment_vehicles = this->vehicles[segment];
+
+    // Perform the lane switches, then the lane moves in the traversal order of the inputs
+    road_ptr->switchLanes();
+    const bool by_position = this->traversal_order == 1;
+    const std::vector<Vehicle *> &traversal = by_position ? this->ordered_vehicles : segment_vehicles;
+    if (by_position) {
+        road_ptr->getOrderedVehicles(&this->ordered_vehicles);
+    }
+    for (const auto &vehicle: traversal) {
+        vehicle->updateGaps(road_ptr);
+    }
+    std::vector<std::pair<Vehicle *, int> > exited;
+    for (const auto &vehicle: traversal) {
+        if (const int time_on_road = vehicle->performLaneMove(); time_on_road != 0) {
+            exited.emplace_back(vehicle, time_on_road);
+        }
+    }
+    road_ptr->removeExitedVehicles();
+    if (exited.empty()) {
+        return 0;
+    }
+
+    // Send the Vehicles that left the segment into their links
+    for (const auto &[vehicle, time_on_road]: exited) {
+        this->sendVehicle(segment, {
+                              segment, vehicle->getLane()->getLaneNumber(), vehicle->getSpeed(), time_on_road, segment,
+                              vehicle->getId()
+                          }, transfers, exits);
+    }
+    segment_vehicles.erase(std::remove_if(segment_vehicles.begin(), segment_vehicles.end(), [](const Vehicle *v) {
+        return v->hasExited();
+    }), segment_vehicles.end());
+    for (const auto &[vehicle, time_on_road]: exited) {
+        delete vehicle;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step on a segment of the process in the macroscopic model, sending the Vehicles flowing out of its
+ * last cell into their links
+ * @param segment the number of the segment
+ * @param transfers pointer to the packed Vehicle transfers for each process
+ * @param exits pointer to the packed exits from the network
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::stepMacroSegment(const int segment, std::vector<std::vector<int> > *transfers,
+                                  std::vector<int> *exits) {
+    std::vector<VehicleTransfer> departures;
+    this->macro_segments[segment]->step(this->time, &departures);
+    for (const auto &departure: departures) {
+        this->sendVehicle(segment, departure, transfers, exits);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Exchanges the Vehicle transfers between the processes, and sends the exits from the network to the first process,
+ * which measures the travel times. The transfers received are queued at the end of their links in the order of the
+ * segment they left and their id, and the exits are ordered by the segment they left, so that the order does not
+ * depend on the partition.
+ * @param transfers the packed Vehicle transfers for each process
+ * @param exits the packed exits from the network of the process
+ * @param exit_travel_times pointer to the times on road of the Vehicles that left the network, on the first process
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::exchangeVehicles(const std::vector<std::vector<int> > &transfers, const std::vector<int> &exits,
+                                  std::vector<int> *exit_travel_times) {
+    // Share how much each process sends to each process, the exits going to the first one
+    const int num_counts = this->num_processes + 1;
+    std::vector<int> counts(num_counts);
+    for (int q = 0; q < this->num_processes; q++) {
+        counts[q] = static_cast<int>(transfers[q].size());
+    }
+    counts[this->num_processes] = static_cast<int>(exits.size());
+    std::vector<int> all_counts(static_cast<size_t>(this->num_processes) * num_counts);
+    MPI_Allgather(counts.data(), num_counts, MPI_INT, all_counts.data(), num_counts, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> send_counts(this->num_processes);
+    std::vector<int> send_displacements(this->num_processes);
+    std::vector<int> send_buffer;
+    for (int q = 0; q < this->num_processes; q++) {
+        send_displacements[q] = static_cast<int>(send_buffer.size());
+        send_buffer.insert(send_buffer.end(), transfers[q].begin(), transfers[q].end());
+        if (q == 0) {
+            send_buffer.insert(send_buffer.end(), exits.begin(), exits.end());
+        }
+        send_counts[q] = static_cast<int>(send_buffer.size()) - send_displacements[q];
+    }
+    std::vector<int> receive_counts(this->num_processes);
+    std::vector<int> receive_displacements(this->num_processes);
+    int receive_size = 0;
+    for (int p = 0; p < this->num_processes; p++) {
+        receive_displacements[p] = receive_size;
+        receive_counts[p] = all_counts[p * num_counts + this->rank] +
+                            (this->rank == 0 ? all_counts[p * num_counts + this->num_processes] : 0);
+        receive_size += receive_counts[p];
+    }
+    if (std::all_of(all_counts.begin(), all_counts.end(), [](const int count) { return count == 0; })) {
+        return 0;
+    }
+    std::vector<int> receive_buffer(receive_size);
+    if (const int status = MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displacements.data(), MPI_INT,
+                                         receive_buffer.data(), receive_counts.data(), receive_displacements.data(),
+                                         MPI_INT, MPI_COMM_WORLD); status != MPI_SUCCESS) {
+        return status;
+    }
+
+    // Unpack the transfers and the exits of each process
+    std::vector<VehicleTransfer> arrivals;
+    std::vector<std::pair<int, int> > network_exits;
+    for (int p = 0; p < this->num_processes; p++) {
+        const int *values = receive_buffer.data() + receive_displacements[p];
+        const int num_transfer_values = all_counts[p * num_counts + this->rank];
+        for (int n = 0; n < num_transfer_values; n += TRANSFER_SIZE) {
+            arrivals.push_back({values[n], values[n + 1], values[n + 2], values[n + 3], values[n + 4], values[n + 5]});
+        }
+        for (int n = num_transfer_values; n < receive_counts[p]; n += EXIT_SIZE) {
+            network_exits.emplace_back(values[n], values[n + 1]);
+        }
+    }
+    std::sort(arrivals.begin(), arrivals.end(), [](const VehicleTransfer &a, const VehicleTransfer &b) {
+        return std::tie(a.segment, a.lane, a.origin, a.origin_id) < std::tie(b.segment, b.lane, b.origin, b.origin_id);
+    });
+    for (const auto &arrival: arrivals) {
+        this->waiting_vehicles[arrival.segment][arrival.lane].push_back(arrival);
+    }
+    std::stable_sort(network_exits.begin(), network_exits.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+    for (const auto &[segment, time_on_road]: network_exits) {
+        exit_travel_times->push_back(time_on_road);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Moves the first Vehicle waiting at the end of the links into each Lane of a segment when its first site is empty.
+ * The Vehicle gets a new id from the segment, whose random numbers it draws from now on, and keeps its speed and time
+ * on road. The Vehicles still waiting spend the step on the road too.
+ * @param segment the number of the segment
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::enterVehicles(const int segment) {
+    const std::vector<Lane *> &lanes = this->roads[segment]->getLanes();
+    for (int i = 0; i < this->segments[segment].num_lanes; i++) {
+        std::deque<VehicleTransfer> &waiting = this->waiting_vehicles[segment][i];
+        if (!waiting.empty() && !lanes[i]->hasVehicleInSite(0)) {
+            auto *vehicle = new Vehicle(lanes[i], this->next_ids[segment]++, 0, this->segment_inputs[segment], 0);
+            vehicle->setSpeed(waiting.front().speed);
+            vehicle->setTimeOnRoad(waiting.front().time_on_road);
+            lanes[i]->placeVehicle(vehicle);
+            this->vehicles[segment].push_back(vehicle);
+            waiting.pop_front();
+        }
+        for (auto &transfer: waiting) {
+            transfer.time_on_road++;
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Gets the highest density of the stretches of a segment in the CA rules as long as the windows of cells over which the
+ * macroscopic model measures its density
+ * @param segment the number of the segment
+ * @return the largest number of Vehicles per site of a stretch
+ */
+double RoadNetwork::getCellularDensity(const int segment) const {
+    const int window_length = DENSITY_WINDOW * MacroSegment::getCellLength(this->segment_inputs[segment]);
+    const int length = this->segments[segment].length;
+    std::vector<int> counts((length + window_length - 1) / window_length, 0);
+    for (const auto &vehicle: this->vehicles[segment]) {
+        counts[vehicle->getPosition() / window_length]++;
+    }
+    double max_density = 0.0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        const int window_size = std::min(window_length, length - static_cast<int>(i) * window_length);
+        max_density = std::max(max_density, static_cast<double>(counts[i]) /
+                                            (window_size * this->segments[segment].num_lanes));
+    }
+    return max_density;
+}
+
+/**
+ * Switches a segment from the CA rules to the macroscopic model, counting its Vehicles into the cells of their sites
+ * in order of decreasing position, and emptying its Road
+ * @param segment the number of the segment
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::switchToMacro(const int segment) {
+    auto *macro_segment = new MacroSegment(this->segment_inputs[segment], this->segments[segment].num_lanes,
+                                           this->segments[segment].length);
+    std::vector<Vehicle *> &segment_vehicles = this->vehicles[segment];
+    std::sort(segment_vehicles.begin(), segment_vehicles.end(), [](const Vehicle *a, const Vehicle *b) {
+        return a->getPosition() != b->getPosition()
+                   ? a->getPosition() > b->getPosition()
+                   : a->getLane()->getLaneNumber() < b->getLane()->getLaneNumber();
+    });
+    for (const auto &vehicle: segment_vehicles) {
+        macro_segment->addVehicle(vehicle->getPosition(), {
+                                      segment, vehicle->getLane()->getLaneNumber(), vehicle->getSpeed(),
+                                      vehicle->getTimeOnRoad(), segment, vehicle->getId()
+                                  }, this->time);
+    }
+    this->roads[segment]->clearVehicles();
+    for (const auto &vehicle: segment_vehicles) {
+        delete vehicle;
+    }
+    segment_vehicles.clear();
+    this->macro_segments[segment] = macro_segment;
+    this->num_mode_switches++;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Switches a segment from the macroscopic model back to the CA rules, placing the Vehicles of each cell evenly over
+ * its sites and Lanes. The Vehicles get a new id from the segment and keep their time on road.
+ * @param segment the number of the segment
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::switchToCellular(const int segment) {
+    std::vector<VehiclePlacement> placements;
+    this->macro_segments[segment]->unload(this->time, &placements);
+    delete this->macro_segments[segment];
+    this->macro_segments[segment] = nullptr;
+    const std::vector<Lane *> &lanes = this->roads[segment]->getLanes();
+    for (const auto &placement: placements) {
+        auto *vehicle = new Vehicle(lanes[placement.lane], this->next_ids[segment]++, placement.site,
+                                    this->segment_inputs[segment], 0);
+        vehicle->setSpeed(placement.speed);
+        vehicle->setTimeOnRoad(placement.record.time_on_road);
+        if (const int status = lanes[placement.lane]->placeVehicle(vehicle); status != 0) {
+            delete vehicle;
+            return status;
+        }
+        this->vehicles[segment].push_back(vehicle);
+    }
+    this->num_mode_switches++;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Switches the segments of the process between the CA rules and the macroscopic model on their density. A segment in
+ * the CA rules switches when every stretch of the density window is below the macroscopic density and no Vehicles wait
+ * to enter it, and a macroscopic segment switches back when a stretch exceeds it by the hysteresis factor, or when more
+ * Vehicles wait to enter it than it has Lanes, as a jam forms or reaches it from downstream.
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::updateModes() {
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        if (this->roads[s] == nullptr) {
+            continue;
+        }
+        size_t num_waiting = 0;
+        for (const auto &lane_waiting: this->waiting_vehicles[s]) {
+            num_waiting += lane_waiting.size();
+        }
+        if (this->macro_segments[s] == nullptr) {
+            if (num_waiting == 0 && this->getCellularDensity(s) < this->macro_density) {
+                this->switchToMacro(s);
+            }
+        } else if (this->macro_segments[s]->getMaxDensity(DENSITY_WINDOW) > MACRO_HYSTERESIS * this->macro_density ||
+                   num_waiting > static_cast<size_t>(this->segments[s].num_lanes)) {
+            if (const int status = this->switchToCellular(s); status != 0) {
+                return status;
+            }
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step on all the segments of the process, in the CA rules or the macroscopic model, then moves the
+ * Vehicles that left their segment into the next one
+ * @param exit_travel_times pointer to the times on road of the Vehicles that left the network in the step, on the
+ *                          first process
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::step(std::vector<int> *exit_travel_times) {
+    this->time++;
+    std::vector<std::vector<int> > transfers(this->num_processes);
+    std::vector<int> exits;
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        if (this->macro_segments[s] != nullptr) {
+            this->stepMacroSegment(s, &transfers, &exits);
+            this->num_macro_steps++;
+        } else if (this->roads[s] != nullptr) {
+            this->stepSegment(s, &transfers, &exits);
+        }
+        if (this->roads[s] != nullptr) {
+            this->num_segment_steps++;
+        }
+    }
+    if (const int status = this->exchangeVehicles(transfers, exits, exit_travel_times); status != 0) {
+        return status;
+    }
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        if (this->macro_segments[s] != nullptr) {
+            this->macro_segments[s]->receive(&this->waiting_vehicles[s], this->time, &this->next_ids[s]);
+        } else if (this->roads[s] != nullptr) {
+            this->enterVehicles(s);
+        }
+    }
+
+    // Switch the segments between the CA rules and the macroscopic model on their density
+    if (this->macro_density > 0.0 && this->time % MODE_CHECK_INTERVAL == 0) {
+        this->updateModes();
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Attempts to spawn Vehicles on each Lane of the entry segments of the process. The empty Road of a macroscopic
+ * segment spawns its Vehicles too, which then wait to flow into its first cell.
+ * @param time the simulation time
+ * @return 0 if successful, nonzero otherwise
+ */
+int RoadNetwork::attemptSpawn(const int time) {
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        if (this->roads[s] == nullptr || !this->segments[s].entry) {
+            continue;
+        }
+        this->roads[s]->attemptSpawn(this->segment_inputs[s], time, &this->vehicles[s], &this->next_ids[s]);
+        if (this->macro_segments[s] != nullptr) {
+            this->roads[s]->clearVehicles();
+            for (const auto &vehicle: this->vehicles[s]) {
+                const int lane = vehicle->getLane()->getLaneNumber();
+                this->waiting_vehicles[s][lane].push_back({
+                    s, lane, vehicle->getSpeed(), vehicle->getTimeOnRoad(), s, vehicle->getId()
+                });
+                delete vehicle;
+            }
+            this->vehicles[s].clear();
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Checks whether the process measures the travel times through the network, which the first process does
+ * @return whether the process is the first one
+ */
+bool RoadNetwork::ownsResults() const {
+    return this->rank == 0;
+}
+
+/**
+ * Shares the decision to stop the simulation of the first process, the only one measuring the travel times, with all
+ * the processes, so that they stop at the same step
+ * @param stop whether the first process stops, ignored on the other processes
+ * @return whether all the processes stop
+ */
+bool RoadNetwork::shareStop(const bool stop) const {
+    int flag = stop ? 1 : 0;
+    MPI_Bcast(&flag, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return flag != 0;
+}
+
+/**
+ * Prints the share of the network of the process: its segments and cells, the links cut by the partition and the
+ * Vehicles the process sent to other processes, and how much of it ran in the macroscopic model
+ */
+void RoadNetwork::printPartitionSummary() const {
+    int num_owned = 0;
+    long owned_cells = 0;
+    long total_cells = 0;
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        const long cells = static_cast<long>(this->segments[s].num_lanes) * this->segments[s].length;
+        total_cells += cells;
+        if (this->owners[s] == this->rank) {
+            num_owned++;
+            owned_cells += cells;
+        }
+    }
+    const auto num_cut = std::count_if(this->links.begin(), this->links.end(), [this](const NetworkLink &link) {
+        return this->owners[link.from] != this->owners[link.to];
+    });
+    std::cout << "network partition: process " << this->rank << " owns " << num_owned << " of "
+            << this->segments.size() << " segments with " << owned_cells << " of " << total_cells << " cells, "
+            << num_cut << " of " << this->links.size() << " links cut, " << this->num_remote_transfers << " of "
+            << this->num_transfers << " vehicle transfers to other processes" << std::endl;
+    if (this->macro_density > 0.0) {
+        std::cout << "macroscopic model: process " << this->rank << " switched " << this->num_mode_switches
+                << " times between the CA rules and the macroscopic model, "
+                << (this->num_segment_steps > 0
+                        ? 100.0 * static_cast<double>(this->num_macro_steps) / this->num_segment_steps
+                        : 0.0) << "% of its segment steps macroscopic" << std::endl;
+    }
+}
+
+/**
+ * Debug method to print the segments of the process
+ */
+#ifdef DEBUG
+void RoadNetwork::printNetwork() const {
+    for (int s = 0; s < static_cast<int>(this->segments.size()); s++) {
+        if (this->macro_segments[s] != nullptr) {
+            std::cout << "segment " << this->segments[s].name << ": macroscopic, "
+                    << this->macro_segments[s]->getNumVehicles() << " vehicles" << std::endl;
+        } else if (this->roads[s] != nullptr) {
+            std::cout << "segment " << this->segments[s].name << ":" << std::endl;
+            this->roads[s]->printRoad();
+        }
+    }
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_ROADNETWORK_H
+#define CA_TRAFFIC_SIMULATION_ROADNETWORK_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Inputs.h"
+#include "ProcessData.h"
+#include "Road.h"
+#include "KeyedRandom.h"
+
+// Largest fraction by which the cells of a process may exceed an even share when refining the partition of the network
+constexpr double PARTITION_IMBALANCE = 0.05;
+
+// Number of steps between checks of the density of the segments switching between the CA rules and the macroscopic
+// model, the number of cells of the macroscopic model over which the local density is measured, and the factor above
+// the switching density at which a macroscopic segment switches back to the CA rules
+constexpr int MODE_CHECK_INTERVAL = 10;
+constexpr int DENSITY_WINDOW = 10;
+constexpr double MACRO_HYSTERESIS = 2.0;
+
+class MacroSegment;
+
+/**
+ * Structure for a segment of the road network, a Road of its own number of Lanes and sites, which Vehicles enter from
+ * the demand of the inputs if it is an entry (such as an on-ramp)
+ */
+struct NetworkSegment {
+    std::string name;
+    int num_lanes;
+    int length;
+    bool entry;
+};
+
+/**
+ * Structure for a link of the road network, which takes its share of the Vehicles leaving the end of a segment into the
+ * start of another segment. Several links leaving a segment form a diverge (or an off-ramp), several links entering a
+ * segment a merge (or an on-ramp).
+ */
+struct NetworkLink {
+    int from;
+    int to;
+    double share;
+};
+
+/**
+ * Structure for a Vehicle crossing a link of the network, from the end of a segment into the first site of a Lane of
+ * the next segment, which waits at the end of the link while that site is occupied
+ */
+struct VehicleTransfer {
+    int segment;
+    int lane;
+    int speed;
+    int time_on_road;
+    int origin;
+    int origin_id;
+};
+
+/**
+ * Class for a network of Road segments joined by links, read from "road-network.dat". The segments are partitioned
+ * between the processes, balancing their cells while cutting few links, and each process steps its own segments with
+ * the rules of the reference engine. The Vehicles leaving a segment take one of its links, and are transferred to the
+ * process of the next segment at the end of each step. Each segment draws its random numbers with its own seed, so
+ * that with a seed the results do not depend on the number of processes. With a macroscopic density in the inputs, the
+ * segments that are nearly empty switch to the cell transmission model of a MacroSegment, and back to the CA rules
+ * where the density rises, so that only the congested segments are simulated site by site.
+ */
+class RoadNetwork {
+    int rank;
+    int num_processes;
+    int traversal_order;
+    std::vector<NetworkSegment> segments;
+    std::vector<NetworkLink> links;
+    std::vector<std::vector<int> > outgoing_links;
+    std::vector<int> owners;
+    std::vector<Inputs> segment_inputs;
+    std::vector<KeyedRandom> segment_randoms;
+    std::vector<Road *> roads;
+    std::vector<std::vector<Vehicle *> > vehicles;
+    std::vector<int> next_ids;
+    std::vector<std::vector<std::deque<VehicleTransfer> > > waiting_vehicles;
+    std::vector<Vehicle *> ordered_vehicles;
+    std::vector<MacroSegment *> macro_segments;
+    double macro_density;
+    int time;
+    long num_transfers;
+    long num_remote_transfers;
+    long num_mode_switches;
+    long num_macro_steps;
+    long num_segment_steps;
+
+    int readNetwork(const std::string &file_name);
+
+    int partitionSegments();
+
+    int selectLink(int segment, int id, int time_on_road) const;
+
+    int sendVehicle(int segment, const VehicleTransfer &departure, std::vector<std::vector<int> > *transfers,
+                    std::vector<int> *exits);
+
+    int stepSegment(int segment, std::vector<std::vector<int> > *transfers, std::vector<int> *exits);
+
+    int stepMacroSegment(int segment, std::vector<std::vector<int> > *transfers, std::vector<int> *exits);
+
+    int exchangeVehicles(const std::vector<std::vector<int> > &transfers, const std::vector<int> &exits,
+                         std::vector<int> *exit_travel_times);
+
+    int enterVehicles(int segment);
+
+    [[nodiscard]] double getCellularDensity(int segment) const;
+
+    int switchToMacro(int segment);
+
+    int switchToCellular(int segment);
+
+    int updateModes();
+
+public:
+    RoadNetwork(const Inputs &inputs, const ProcessData &process_data);
+
+    ~RoadNetwork();
+
+    int step(std::vector<int> *exit_travel_times);
+
+    int attemptSpawn(int time);
+
+    [[nodiscard]] bool ownsResults() const;
+
+    [[nodiscard]] bool shareStop(bool stop) const;
+
+    void printPartitionSummary() const;
+
+#ifdef DEBUG
+    void printNetwork() const;
+#endif
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_ROADNETWORK_H
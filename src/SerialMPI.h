@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_SERIALMPI_H
+#define CA_TRAFFIC_SIMULATION_SERIALMPI_H
+
+#include <chrono>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * Stand-ins for the MPI functions used by the simulation in the serial build without MPI (NO_MPI), where the single
+ * process is the whole communicator: the collectives copy the data of the process to itself, and the neighbours of the
+ * process are always MPI_PROC_NULL. The datatypes are their sizes in bytes, and the files are POSIX file descriptors.
+ */
+using MPI_Comm = int;
+using MPI_Datatype = int;
+using MPI_File = int;
+using MPI_Info = int;
+using MPI_Offset = long long;
+using MPI_Op = int;
+struct MPI_Status {
+};
+
+constexpr MPI_Comm MPI_COMM_WORLD = 0;
+constexpr MPI_Datatype MPI_BYTE = 1;
+constexpr MPI_Datatype MPI_INT = sizeof(int);
+constexpr MPI_Datatype MPI_DOUBLE = sizeof(double);
+constexpr MPI_Datatype MPI_UNSIGNED_LONG_LONG = sizeof(unsigned long long);
+constexpr MPI_Op MPI_MIN = 0;
+constexpr int MPI_SUCCESS = 0;
+constexpr int MPI_PROC_NULL = -2;
+constexpr MPI_Info MPI_INFO_NULL = 0;
+constexpr int MPI_MODE_CREATE = O_CREAT;
+constexpr int MPI_MODE_WRONLY = O_WRONLY;
+#define MPI_STATUS_IGNORE nullptr
+
+inline int MPI_Init(int *, char ***) {
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Finalize() {
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Comm_rank(MPI_Comm, int *rank) {
+    *rank = 0;
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Comm_size(MPI_Comm, int *size) {
+    *size = 1;
+    return MPI_SUCCESS;
+}
+
+inline double MPI_Wtime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline int MPI_Bcast(void *, int, MPI_Datatype, int, MPI_Comm) {
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Allgather(const void *send_buffer, const int send_count, const MPI_Datatype send_type,
+                         void *receive_buffer, int, MPI_Datatype, MPI_Comm) {
+    std::memcpy(receive_buffer, send_buffer, static_cast<size_t>(send_count) * send_type);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Allreduce(const void *send_buffer, void *receive_buffer, const int count, const MPI_Datatype type,
+                         MPI_Op, MPI_Comm) {
+    std::memcpy(receive_buffer, send_buffer, static_cast<size_t>(count) * type);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Alltoallv(const void *send_buffer, const int *send_counts, const int *send_displacements,
+                         const MPI_Datatype send_type, void *receive_buffer, const int *, const int *receive_displacements,
+                         const MPI_Datatype receive_type, MPI_Comm) {
+    std::memcpy(static_cast<char *>(receive_buffer) + static_cast<size_t>(receive_displacements[0]) * receive_type,
+                static_cast<const char *>(send_buffer) + static_cast<size_t>(send_displacements[0]) * send_type,
+                static_cast<size_t>(send_counts[0]) * send_type);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Sendrecv(const void *, int, MPI_Datatype, int, int, void *, int, MPI_Datatype, int, int, MPI_Comm,
+                        MPI_Status *) {
+    return MPI_SUCCESS;
+}
+
+inline int MPI_File_open(MPI_Comm, const char *file_name, const int mode, MPI_Info, MPI_File *file) {
+    *file = open(file_name, mode, 0644);
+    return *file < 0 ? 1 : MPI_SUCCESS;
+}
+
+inline int MPI_File_set_size(const MPI_File file, const MPI_Offset size) {
+    return ftruncate(file, size) != 0 ? 1 : MPI_SUCCESS;
+}
+
+inline int MPI_File_write_at(const MPI_File file, const MPI_Offset offset, const void *buffer, const int count,
+                             const MPI_Datatype type, MPI_Status *) {
+    const char *data = static_cast<const char *>(buffer);
+    size_t num_written = 0;
+    const size_t size = static_cast<size_t>(count) * type;
+    while (num_written < size) {
+        const ssize_t n = pwrite(file, data + num_written, size - num_written, offset + num_written);
+        if (n <= 0) {
+            return 1;
+        }
+        num_written += n;
+    }
+    return MPI_SUCCESS;
+}
+
+inline int MPI_File_write_at_all(const MPI_File file, const MPI_Offset offset, const void *buffer, const int count,
+                                 const MPI_Datatype type, MPI_Status *status) {
+    return MPI_File_write_at(file, offset, buffer, count, type, status);
+}
+
+inline int MPI_File_close(MPI_File *file) {
+    return close(*file) != 0 ? 1 : MPI_SUCCESS;
+}
+
+
+#endif //CA_TRAFFIC_SIMULATION_SERIALMPI_H
@@ -22,8 +22,24 @@
  *                     manage distributed simulation across multiple processes.
  */
 Simulation::Simulation(const Inputs &inputs, const ProcessData &process_data) {
-    // Create the Road object for the simulation
-    this->road_ptr = new Road(inputs, process_data);
+    // Create the Road object for the simulation, or the fused sweep, multi-spin or halo exchange engine that stores the
+    // Road in its own cell arrays, or the network of Roads
+    this->road_ptr = nullptr;
+    this->sweep_engine_ptr = nullptr;
+    this->multi_spin_engine_ptr = nullptr;
+    this->halo_engine_ptr = nullptr;
+    this->network_ptr = nullptr;
+    if (inputs.engine == ENGINE_SWEEP) {
+        this->sweep_engine_ptr = new SweepEngine(inputs, process_data);
+    } else if (inputs.engine == ENGINE_MULTI_SPIN) {
+        this->multi_spin_engine_ptr = new MultiSpinEngine(inputs, process_data);
+    } else if (inputs.engine == ENGINE_HALO) {
+        this->halo_engine_ptr = new HaloEngine(inputs, process_data);
+    } else if (inputs.engine == ENGINE_NETWORK) {
+        this->network_ptr = new RoadNetwork(inputs, process_data);
+    } else {
+        this->road_ptr = new Road(inputs, process_data);
+    }
 
     // Set the simulation time to zero
     this->time = 0;
@@ -34,118 +50,678 @@ Simulation::Simulation(const Inputs &inputs, const ProcessData &process_data) {
     // Obtain the simulation inputs
     this->inputs = inputs;
 
+    // When stopping at a target precision the samples are recorded from the start, and the transient is found from them
+    // instead of the warmup time
+    if (inputs.target_precision > 0.0) {
+        this->inputs.warmup_time = 0;
+    }
+    this->truncation_point = -1;
+    this->half_width = 0.0;
+    this->precision_reached = false;
+
     // Initialize Statistic for travel time
     this->travel_time = new Statistic();
+
+    // Initialize Statistics for the flow and mean speed of the ring road
+    this->flow = new Statistic();
+    this->mean_speed = new Statistic();
+
+    // Populate the ring road, which has a fixed number of Vehicles and no inflow
+    if (inputs.boundary == BOUNDARY_PERIODIC) {
+        if (this->sweep_engine_ptr != nullptr) {
+            this->sweep_engine_ptr->populate(inputs.percent_full, &this->next_id);
+        } else if (this->multi_spin_engine_ptr != nullptr) {
+            this->multi_spin_engine_ptr->populate(inputs.percent_full);
+        } else {
+            this->road_ptr->populate(inputs, &this->vehicles, &this->next_id);
+        }
+    }
+
+    // Create the live feed of the state of the process, starting with the initial state
+    this->live_feed = nullptr;
+    if (inputs.feed_interval > 0) {
+        this->live_feed = new LiveFeed();
+        if (const int status = this->live_feed->create(process_data.getRank(), inputs.num_lanes, inputs.feed_bins);
+            status != 0) {
+            throw std::exception();
+        }
+        this->publishFeed();
+    }
+
+    // Create the snapshot file shared by the processes, starting with the initial state
+    this->snapshot_file = nullptr;
+    if (inputs.snapshot_interval > 0) {
+        this->snapshot_file = new SnapshotFile(process_data);
+        if (const int status = this->snapshot_file->create("cats-snapshots.dat", inputs.num_lanes,
+                                                           inputs.snapshot_interval); status != 0) {
+            throw std::exception();
+        }
+        this->writeSnapshot();
+    }
 }
 
 /**
  * Destructor for the Simulation
  */
 Simulation::~Simulation() {
-    // Delete the Road object in the simulation
+    // Delete the Road object, the fused sweep, multi-spin or halo exchange engine or the network in the simulation
     delete this->road_ptr;
+    delete this->sweep_engine_ptr;
+    delete this->multi_spin_engine_ptr;
+    delete this->halo_engine_ptr;
+    delete this->network_ptr;
 
     // Delete all the Vehicle objects in the Simulation
     for (const auto &vehicle: this->vehicles) {
         delete vehicle;
     }
+
+    // Delete the Statistics of the Simulation
+    delete this->travel_time;
+    delete this->flow;
+    delete this->mean_speed;
+
+    // Delete the live feed, which marks it finished for its viewers
+    delete this->live_feed;
+
+    // Delete the snapshot file, which writes its index
+    delete this->snapshot_file;
 }
 
 /**
- * Executes the simulation
+ * Adds the flow and the mean speed of a time step on the ring road to their Statistics
+ * @param num_wrapped the number of Vehicles that passed the end of their Lane in the step
+ * @param speed_sum the sum of the speeds of all the Vehicles after the step
+ * @param num_vehicles the number of Vehicles on the Road
  * @return 0 if successful, nonzero otherwise
  */
-int Simulation::run_simulation() {
-    // Obtain the start time
-    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+int Simulation::addRingStatistics(const int num_wrapped, const long speed_sum, const int num_vehicles) const {
+    // The flow is measured in Vehicles per step per Lane at the end of the Lanes and the mean speed in sites per step
+    this->flow->addValue(static_cast<double>(num_wrapped) / this->inputs.num_lanes);
+    if (num_vehicles > 0) {
+        this->mean_speed->addValue(static_cast<double>(speed_sum) / num_vehicles);
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Checks whether the measured series, the travel times of the Vehicles or the flow on the ring road, has passed its
+ * initial transient and the confidence interval of its average after the transient is as narrow as the target precision
+ * relative to the average. All the processes must check it together when they share the stop.
+ * @return whether the simulation can stop
+ */
+bool Simulation::checkPrecision() {
+    bool stop = false;
+    if (this->hasResult()) {
+        const Statistic *series = this->inputs.boundary == BOUNDARY_PERIODIC ? this->flow : this->travel_time;
+        this->truncation_point = series->getTruncationPoint();
+        if (this->truncation_point >= 0) {
+            this->half_width = series->getHalfWidth(this->truncation_point);
+            stop = this->half_width <= this->inputs.target_precision * std::abs(series->getAverage(this->truncation_point));
+        }
+    }
+    this->precision_reached = stop;
 
+    // The processes of the halo exchange engine and of the network stop together
+    if (this->halo_engine_ptr != nullptr) {
+        return this->halo_engine_ptr->shareStop(stop);
+    }
+    if (this->network_ptr != nullptr) {
+        return this->network_ptr->shareStop(stop);
+    }
+
+    // The processes of the other engines simulate their own Roads, and stop together once all of them reached the
+    // precision when they write the snapshots together
+    if (this->snapshot_file != nullptr) {
+        const int flag = stop ? 1 : 0;
+        int all_flags = 0;
+        MPI_Allreduce(&flag, &all_flags, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        return all_flags != 0;
+    }
+    return stop;
+}
+
+/**
+ * Publishes a snapshot of the Lanes of the process and of the summary counters of the simulation in the live feed
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::publishFeed() {
+    FeedSummary summary{};
+    summary.time = this->time;
+    summary.lane_offset = this->getLaneOffset();
+    for (int i = 0; i < this->inputs.num_lanes; i++) {
+        const Span<int8_t> speeds = this->getLaneSpeeds(i);
+        this->live_feed->binLane(i, speeds);
+        summary.lane_size = static_cast<int64_t>(speeds.size());
+        summary.num_vehicles += std::count_if(speeds.begin(), speeds.end(), [](const int8_t speed) {
+            return speed >= 0;
+        });
+    }
+
+    // The averages of the statistics so far, which are zero until they have samples
+    const Statistic *series = this->inputs.boundary == BOUNDARY_PERIODIC ? this->flow : this->travel_time;
+    summary.num_samples = series->getNumSamples();
+    if (this->travel_time->getNumSamples() > 0) {
+        summary.travel_time = this->travel_time->getAverage();
+    }
+    if (this->flow->getNumSamples() > 0) {
+        summary.flow = this->flow->getAverage();
+    }
+    if (this->mean_speed->getNumSamples() > 0) {
+        summary.mean_speed = this->mean_speed->getAverage();
+    }
+    return this->live_feed->publish(summary);
+}
+
+/**
+ * Writes a snapshot of the Lanes of the process into the snapshot file, together with the other processes
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::writeSnapshot() {
+    for (int i = 0; i < this->inputs.num_lanes; i++) {
+        this->snapshot_file->encodeLane(this->getLaneSpeeds(i));
+    }
+    return this->snapshot_file->write(this->time, this->getLaneOffset());
+}
+
+/**
+ * Performs a time step with the reference engine, in which each Vehicle object updates its gaps and performs its lane
+ * switch and lane move in separate passes over all the Vehicles
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::performReferenceStep() {
     // Declare a vector for vehicles to be removed each step
-    std::vector<int> vehicles_to_remove;
+    std::vector<Vehicle *> vehicles_to_remove;
 
-    while (this->time < this->inputs.max_time) {
 #ifdef DEBUG
-        std::cout << "road configuration at time " << time << ":" << std::endl;
-        this->road_ptr->printRoad();
-        std::cout << "performing lane switches..." << std::endl;
+    std::cout << "road configuration at time " << time << ":" << std::endl;
+    this->road_ptr->printRoad();
+    std::cout << "performing lane switches..." << std::endl;
 #endif
 
-        // Perform the lane switch step for all vehicles
-        for (const auto &vehicle: this->vehicles) {
-            vehicle->updateGaps(this->road_ptr);
+    // Perform the lane switch step for all vehicles, proposed, resolved and committed Lane by Lane
+    this->road_ptr->switchLanes();
+
+    // Traverse the vehicles of the lane moves either by position, Lane after Lane, or in the order they were spawned
+    const bool by_position = this->inputs.traversal_order == 1;
+    const std::vector<Vehicle *> &traversal = by_position ? this->ordered_vehicles : this->vehicles;
+    if (by_position) {
+        this->road_ptr->getOrderedVehicles(&this->ordered_vehicles);
+    }
+
+#ifdef DEBUG
+    this->road_ptr->printRoad();
+    std::cout << "performing lane movements..." << std::endl;
+#endif
+
+    // Perform the independent lane updates
+    for (const auto &vehicle: traversal) {
+        vehicle->updateGaps(this->road_ptr);
 #ifdef DEBUG
-            vehicle->printGaps();
+        vehicle->printGaps();
 #endif
+    }
+
+    // TODO: Add parallel logic in performLaneMove
+    for (const auto &vehicle: traversal) {
+        if (const int time_on_road = vehicle->performLaneMove(); time_on_road != 0) {
+            vehicles_to_remove.push_back(vehicle);
+        }
+    }
+    this->road_ptr->removeExitedVehicles();
+
+    // End of iteration steps
+    // Increment time
+    this->time++;
+
+    // On the ring road no Vehicles leave or enter, the ones that passed the end of their Lane are counted for the flow
+    if (this->inputs.boundary == BOUNDARY_PERIODIC) {
+        const int num_wrapped = this->road_ptr->rotateWrappedVehicles();
+        if (this->time > this->inputs.warmup_time) {
+            long speed_sum = 0;
+            for (const auto &vehicle: this->vehicles) {
+                speed_sum += vehicle->getSpeed();
+            }
+            this->addRingStatistics(num_wrapped, speed_sum, static_cast<int>(this->vehicles.size()));
         }
+        return 0;
+    }
 
-        for (const auto &vehicle: this->vehicles) {
-            vehicle->performLaneSwitch(this->road_ptr);
+    // Remove finished vehicles
+    for (const auto &vehicle: vehicles_to_remove) {
+        // Update travel time statistic if beyond warm-up period
+        if (this->time > this->inputs.warmup_time) {
+            this->travel_time->addValue(vehicle->getTravelTime(this->inputs));
+            if (!this->inputs.vehicle_classes.empty()) {
+                this->travel_time_classes.push_back(vehicle->getClass());
+            }
         }
+    }
+    // The exited Vehicles are marked, so they are removed from the list in a single pass
+    if (!vehicles_to_remove.empty()) {
+        this->vehicles.erase(std::remove_if(this->vehicles.begin(), this->vehicles.end(), [](const Vehicle *v) {
+            return v->hasExited();
+        }), this->vehicles.end());
+    }
+
+    // Delete the Vehicles
+    // TODO: Add logic, when the vehicle should be removed
+    for (const auto &vehicle: vehicles_to_remove) {
+        delete vehicle;
+    }
 
+    // Spawn new Vehicles
+    // TODO: Spawn should occurred only in first process
+    this->road_ptr->attemptSpawn(this->inputs, this->time, &this->vehicles, &this->next_id);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step with the fused sweep engine, which performs all the lane switches and lane moves of the step in
+ * a single sweep over its cell arrays
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::performSweepStep() {
 #ifdef DEBUG
-        this->road_ptr->printRoad();
-        std::cout << "performing lane movements..." << std::endl;
+    std::cout << "road configuration at time " << time << ":" << std::endl;
+    this->sweep_engine_ptr->printLanes();
+#endif
+
+    // Perform the lane switches and lane moves of all the vehicles
+    this->sweep_engine_ptr->step(this->time, &this->exit_travel_times);
+
+    // End of iteration steps
+    // Increment time
+    this->time++;
+
+    // Update travel time statistic with the finished vehicles if beyond warm-up period
+    if (this->time > this->inputs.warmup_time) {
+        for (const int time_on_road: this->exit_travel_times) {
+            this->travel_time->addValue(this->inputs.step_size * time_on_road);
+        }
+    }
+    this->exit_travel_times.clear();
+
+    // On the ring road no Vehicles enter, the ones that passed the end of their Lane are counted for the flow
+    if (this->inputs.boundary == BOUNDARY_PERIODIC) {
+        if (this->time > this->inputs.warmup_time) {
+            this->addRingStatistics(this->sweep_engine_ptr->getNumWrapped(), this->sweep_engine_ptr->getSpeedSum(),
+                                    this->sweep_engine_ptr->getNumVehicles());
+        }
+        return 0;
+    }
+
+    // Spawn new Vehicles
+    this->sweep_engine_ptr->attemptSpawn(this->time, &this->next_id);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step with the multi-spin engine in all its replicas of the ring road, whose flow and mean speed are
+ * measured from the end of the warmup period
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::performMultiSpinStep() {
+    if (this->time == std::max(this->inputs.warmup_time, 0)) {
+        this->multi_spin_engine_ptr->startMeasurement();
+    }
+
+    // Perform the lane moves of all the vehicles of all the replicas
+    this->multi_spin_engine_ptr->step();
+
+    // End of iteration steps
+    // Increment time
+    this->time++;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step with the halo exchange engine on the segment of the Road of the process, exchanging the halos
+ * with the neighbour processes when they are due
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::performHaloStep() {
+#ifdef DEBUG
+    std::cout << "road configuration at time " << time << ":" << std::endl;
+    this->halo_engine_ptr->printLanes();
 #endif
 
-        // Perform the independent lane updates
-        for (const auto &vehicle: this->vehicles) {
-            vehicle->updateGaps(this->road_ptr);
+    // Perform the lane switches and lane moves of all the vehicles of the extended segment
+    this->halo_engine_ptr->step(this->time, &this->exit_travel_times);
+
+    // End of iteration steps
+    // Increment time
+    this->time++;
+
+    // Update travel time statistic with the finished vehicles if beyond warm-up period
+    if (this->time > this->inputs.warmup_time) {
+        for (const int time_on_road: this->exit_travel_times) {
+            this->travel_time->addValue(this->inputs.step_size * time_on_road);
+        }
+    }
+    this->exit_travel_times.clear();
+
+    // Spawn new Vehicles on the first process, then bring the halos up to date with the owners of their sites and
+    // rebalance the segments of the processes when they are due
+    this->halo_engine_ptr->attemptSpawn(this->time, &this->next_id);
+    this->halo_engine_ptr->exchangeHalos();
+    this->halo_engine_ptr->rebalance(this->time);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Performs a time step with the road network engine on the segments of the process, and moves the Vehicles that left
+ * their segment into the next one
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::performNetworkStep() {
 #ifdef DEBUG
-            vehicle->printGaps();
+    std::cout << "network configuration at time " << time << ":" << std::endl;
+    this->network_ptr->printNetwork();
 #endif
+
+    // Perform the lane switches and lane moves of all the vehicles of the segments, and their transfers
+    if (const int status = this->network_ptr->step(&this->exit_travel_times); status != 0) {
+        return status;
+    }
+
+    // End of iteration steps
+    // Increment time
+    this->time++;
+
+    // Update travel time statistic with the vehicles that left the network if beyond warm-up period
+    if (this->time > this->inputs.warmup_time) {
+        for (const int time_on_road: this->exit_travel_times) {
+            this->travel_time->addValue(this->inputs.step_size * time_on_road);
         }
+    }
+    this->exit_travel_times.clear();
 
-        // TODO: Add parallel logic in performLaneMove
-        for (int n = 0; n < static_cast<int>(this->vehicles.size()); n++) {
-            if (const int time_on_road = this->vehicles[n]->performLaneMove(); time_on_road != 0) {
-                vehicles_to_remove.push_back(n);
-            }
+    // Spawn new Vehicles on the entry segments
+    this->network_ptr->attemptSpawn(this->time);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Advances the simulation by a number of time steps with its engine
+ * @param num_steps the number of time steps
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::step(const int num_steps) {
+    for (int n = 0; n < num_steps; n++) {
+        if (this->sweep_engine_ptr != nullptr) {
+            this->performSweepStep();
+        } else if (this->multi_spin_engine_ptr != nullptr) {
+            this->performMultiSpinStep();
+        } else if (this->halo_engine_ptr != nullptr) {
+            this->performHaloStep();
+        } else if (this->network_ptr != nullptr) {
+            this->performNetworkStep();
+        } else {
+            this->performReferenceStep();
         }
 
-        // End of iteration steps
-        // Increment time
-        this->time++;
+        // Publish the state in the live feed when it is due
+        if (this->live_feed != nullptr && this->time % this->inputs.feed_interval == 0) {
+            this->publishFeed();
+        }
 
-        // Remove finished vehicles
-        std::sort(vehicles_to_remove.begin(), vehicles_to_remove.end());
-        for (int i = static_cast<int>(vehicles_to_remove.size()) - 1; i >= 0; i--) {
-            // Update travel time statistic if beyond warm-up period
-            if (this->time > this->inputs.warmup_time) {
-                this->travel_time->addValue(this->vehicles[vehicles_to_remove[i]]->getTravelTime(this->inputs));
-            }
+        // Write the snapshot of the Lanes when it is due
+        if (this->snapshot_file != nullptr && this->time % this->inputs.snapshot_interval == 0) {
+            this->writeSnapshot();
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Executes the simulation
+ * @param report whether to print the performance and the results of the simulation
+ * @return 0 if successful, nonzero otherwise
+ */
+int Simulation::run_simulation(const bool report) {
+    // Obtain the start time
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
-            // Delete the Vehicle
-            // TODO: Add logic, when the vehicle should be removed
-            delete this->vehicles[vehicles_to_remove[i]];
-            this->vehicles.erase(this->vehicles.begin() + vehicles_to_remove[i]);
+    while (this->time < this->inputs.max_time) {
+        this->step(1);
+
+        // Stop once the transient is over and the target precision is reached
+        if (this->inputs.target_precision > 0.0 && this->time % this->inputs.precision_check_interval == 0 &&
+            this->checkPrecision()) {
+            break;
         }
-        vehicles_to_remove.clear();
+    }
+
+    // Find the transient and the precision reached when the simulation ran all its steps, and leave the transient out
+    // of the results
+    if (this->inputs.target_precision > 0.0 && this->time == this->inputs.max_time) {
+        this->checkPrecision();
+    }
+    if (this->inputs.target_precision > 0.0 && this->truncation_point >= 0) {
+        this->travel_time->truncate(this->truncation_point);
+        this->travel_time_classes.erase(this->travel_time_classes.begin(), this->travel_time_classes.begin() +
+                                        std::min(this->truncation_point,
+                                                 static_cast<int>(this->travel_time_classes.size())));
+        this->flow->truncate(this->truncation_point);
+        this->mean_speed->truncate(this->truncation_point);
+    }
 
-        // Spawn new Vehicles
-        // TODO: Spawn should occurred only in first process
-        this->road_ptr->attemptSpawn(this->inputs, &this->vehicles, &this->next_id);
+    // The flow and mean speed of each replica of the multi-spin engine, averaged over the steps beyond the warmup
+    // period, are the samples of the statistics
+    if (this->multi_spin_engine_ptr != nullptr && this->inputs.max_time > std::max(this->inputs.warmup_time, 0)) {
+        const int num_steps = this->inputs.max_time - std::max(this->inputs.warmup_time, 0);
+        for (int r = 0; r < MultiSpinEngine::NUM_REPLICAS; r++) {
+            this->flow->addValue(this->multi_spin_engine_ptr->getFlow(r, num_steps));
+            this->mean_speed->addValue(this->multi_spin_engine_ptr->getMeanSpeed(r, num_steps));
+        }
     }
 
     // Print the total run time and average iterations per second and seconds per iteration
     const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     const auto time_elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).
                                   count()) / 1000000.0;
+    if (!report) {
+        return 0;
+    }
     std::cout << "--- Simulation Performance ---" << std::endl;
+    if (this->sweep_engine_ptr != nullptr) {
+        std::cout << "step kernel: " << (this->sweep_engine_ptr->isSpecialised() ? "specialised" : "generic")
+                << " (max_speed=" << this->inputs.max_speed << ", num_lanes=" << this->inputs.num_lanes << ")"
+                << std::endl;
+        if (this->inputs.num_threads > 1 || this->inputs.huge_pages != HUGE_PAGES_NONE) {
+            this->sweep_engine_ptr->printMemoryLocality();
+        }
+    } else if (this->multi_spin_engine_ptr != nullptr) {
+        std::cout << "step kernel: multi-spin (" << MultiSpinEngine::NUM_REPLICAS << " replicas per word)" << std::endl;
+        if (this->inputs.num_threads > 1 || this->inputs.huge_pages != HUGE_PAGES_NONE) {
+            this->multi_spin_engine_ptr->printMemoryLocality();
+        }
+    } else if (this->halo_engine_ptr != nullptr) {
+        this->halo_engine_ptr->printExchangeSummary(time_elapsed, this->time);
+    } else if (this->network_ptr != nullptr) {
+        this->network_ptr->printPartitionSummary();
+    }
     std::cout << "total computation time: " << time_elapsed << " [s]" << std::endl;
-    std::cout << "average time per iteration: " << time_elapsed / inputs.max_time << " [s]" << std::endl;
-    std::cout << "average iterating frequency: " << inputs.max_time / time_elapsed << " [iter/s]" << std::endl;
+    std::cout << "average time per iteration: " << time_elapsed / this->time << " [s]" << std::endl;
+    std::cout << "average iterating frequency: " << this->time / time_elapsed << " [iter/s]" << std::endl;
 
 #ifdef DEBUG
     // Print final road configuration
     std::cout << "final road configuration" << std::endl;
-    this->road_ptr->printRoad();
+    if (this->sweep_engine_ptr != nullptr) {
+        this->sweep_engine_ptr->printLanes();
+    } else if (this->halo_engine_ptr != nullptr) {
+        this->halo_engine_ptr->printLanes();
+    } else if (this->network_ptr != nullptr) {
+        this->network_ptr->printNetwork();
+    } else if (this->road_ptr != nullptr) {
+        this->road_ptr->printRoad();
+    }
 #endif
 
-    // Print the average Vehicle time on the Road
+    // The Vehicles of the halo exchange engine leave the Road on the last process only, and the travel times through
+    // the network are gathered on the first process
+    if (!this->hasResult()) {
+        return 0;
+    }
+
+    // Print the average flow and mean speed on the ring road, or the average Vehicle time on the Road
     std::cout << "--- Simulation Results ---" << std::endl;
+
+    // Report the transient and the precision reached
+    if (this->inputs.target_precision > 0.0) {
+        if (this->truncation_point < 0) {
+            std::cout << "steady state: transient not over after " << this->time << " steps" << std::endl;
+        } else {
+            std::cout << "steady state: transient of " << this->truncation_point << " samples, 95% half-width="
+                    << this->half_width << " after " << this->time << " steps, ";
+            if (this->precision_reached) {
+                std::cout << this->inputs.max_time - this->time << " of " << this->inputs.max_time << " steps saved"
+                        << std::endl;
+            } else {
+                std::cout << "target precision not reached" << std::endl;
+            }
+        }
+    }
+    if (this->inputs.boundary == BOUNDARY_PERIODIC) {
+        std::cout << "flow: avg=" << this->flow->getAverage() << ", std=" << pow(this->flow->getVariance(), 0.5)
+                << ", N=" << this->flow->getNumSamples() << " [vehicles/step/lane]" << std::endl;
+        std::cout << "mean speed: avg=" << this->mean_speed->getAverage() << ", std="
+                << pow(this->mean_speed->getVariance(), 0.5) << ", N=" << this->mean_speed->getNumSamples()
+                << " [sites/step]" << std::endl;
+        return 0;
+    }
+
     std::cout << "time on road: avg=" << this->travel_time->getAverage() << ", std="
             << pow(this->travel_time->getVariance(), 0.5) << ", N=" << this->travel_time->getNumSamples()
             << std::endl;
 
+    // Print the average time on the Road of the Vehicles of each class
+    if (!this->inputs.vehicle_classes.empty()) {
+        const Span<double> travel_times = this->travel_time->getValues();
+        for (int c = 0; c < static_cast<int>(this->inputs.vehicle_classes.size()); c++) {
+            Statistic class_travel_time;
+            for (size_t i = 0; i < travel_times.size(); i++) {
+                if (this->travel_time_classes[i] == c) {
+                    class_travel_time.addValue(travel_times[i]);
+                }
+            }
+            std::cout << "time on road of " << this->inputs.vehicle_classes[c].name << ": avg="
+                    << class_travel_time.getAverage() << ", std=" << pow(class_travel_time.getVariance(), 0.5)
+                    << ", N=" << class_travel_time.getNumSamples() << std::endl;
+        }
+    }
+
     // Return with no errors
     return 0;
 }
+
+/**
+ * Checks whether the process has the results of the simulation, which the processes of the halo exchange engine other
+ * than the last one and of the network other than the first one do not
+ * @return true if the process has the results, false otherwise
+ */
+bool Simulation::hasResult() const {
+    if (this->network_ptr != nullptr) {
+        return this->network_ptr->ownsResults();
+    }
+    return this->halo_engine_ptr == nullptr || this->halo_engine_ptr->ownsRoadEnd();
+}
+
+/**
+ * Getter for the result of the simulation, after it was run
+ * @return the average flow on the ring road, or the average Vehicle time on the Road
+ */
+double Simulation::getResult() const {
+    if (this->inputs.boundary == BOUNDARY_PERIODIC) {
+        return this->flow->getAverage();
+    }
+    return this->travel_time->getAverage();
+}
+
+/**
+ * Getter for the simulation time, the number of steps performed so far
+ * @return the simulation time
+ */
+int Simulation::getTime() const {
+    return this->time;
+}
+
+/**
+ * Getter for the first site of the Road covered by the speeds of the Lanes of the process, which own a segment of the
+ * Road with the halo exchange engine and the whole Road otherwise
+ * @return the first site of the Lanes of the process
+ */
+int Simulation::getLaneOffset() const {
+    if (this->halo_engine_ptr != nullptr) {
+        return this->halo_engine_ptr->getOffset();
+    }
+    return 0;
+}
+
+/**
+ * Getter for a read-only view of the speeds of the sites of a Lane, -1 for the empty sites, valid until the next step.
+ * The cell arrays of the fused sweep and halo exchange engines are viewed without copying. The Vehicles of the
+ * reference engine are written into a buffer of the Simulation first, and the multi-spin engine, whose replicas share
+ * the bits of its words, has no view
+ * @param lane the number of the Lane
+ * @return the speeds of the sites of the Lane
+ */
+Span<int8_t> Simulation::getLaneSpeeds(const int lane) {
+    if (this->sweep_engine_ptr != nullptr) {
+        return this->sweep_engine_ptr->getLaneSpeeds(lane);
+    }
+    if (this->halo_engine_ptr != nullptr) {
+        return this->halo_engine_ptr->getLaneSpeeds(lane);
+    }
+    if (this->road_ptr == nullptr) {
+        return {};
+    }
+    const Lane *lane_ptr = this->road_ptr->getLanes()[lane];
+    this->lane_speeds.assign(lane_ptr->getSize(), -1);
+    for (const auto &vehicle: lane_ptr->getOrderedVehicles()) {
+        if (vehicle->getPosition() < lane_ptr->getSize()) {
+            this->lane_speeds[vehicle->getPosition()] = static_cast<int8_t>(vehicle->getSpeed());
+        }
+    }
+    return {this->lane_speeds.data(), this->lane_speeds.size()};
+}
+
+/**
+ * Getter for the Statistic of the times on road of the Vehicles that left the Road
+ * @return the travel time Statistic
+ */
+const Statistic &Simulation::getTravelTime() const {
+    return *this->travel_time;
+}
+
+/**
+ * Getter for the Statistic of the flow on the ring road
+ * @return the flow Statistic
+ */
+const Statistic &Simulation::getFlow() const {
+    return *this->flow;
+}
+
+/**
+ * Getter for the Statistic of the mean speed on the ring road
+ * @return the mean speed Statistic
+ */
+const Statistic &Simulation::getMeanSpeed() const {
+    return *this->mean_speed;
+}
@@ -8,27 +8,91 @@
 #include <vector>
 
 #include "Road.h"
+#include "SweepEngine.h"
+#include "MultiSpinEngine.h"
+#include "HaloEngine.h"
+#include "RoadNetwork.h"
 #include "Inputs.h"
+#include "LiveFeed.h"
+#include "SnapshotFile.h"
 #include "Statistic.h"
 #include "ProcessData.h"
+#include "Span.h"
 
 /**
- * Class for the simulation. Has a method for running the simulation.
+ * Class for the simulation. Has a method for running the simulation, and methods for advancing it step by step and
+ * observing its Lanes and Statistics in between without copying them, for use as a library. It owns its engine, its
+ * Statistics, its live feed and its snapshot file, so it cannot be copied.
  */
 class Simulation {
     Road *road_ptr;
+    SweepEngine *sweep_engine_ptr;
+    MultiSpinEngine *multi_spin_engine_ptr;
+    HaloEngine *halo_engine_ptr;
+    RoadNetwork *network_ptr;
     int time;
     std::vector<Vehicle *> vehicles;
+    std::vector<Vehicle *> ordered_vehicles;
+    std::vector<int> exit_travel_times;
     Inputs inputs{};
     int next_id;
     Statistic *travel_time;
+    std::vector<int> travel_time_classes;
+    Statistic *flow;
+    Statistic *mean_speed;
+    int truncation_point;
+    double half_width;
+    bool precision_reached;
+    std::vector<int8_t> lane_speeds;
+    LiveFeed *live_feed;
+    SnapshotFile *snapshot_file;
+
+    int performReferenceStep();
+
+    int performSweepStep();
+
+    int performMultiSpinStep();
+
+    int performHaloStep();
+
+    int performNetworkStep();
+
+    int addRingStatistics(int num_wrapped, long speed_sum, int num_vehicles) const;
+
+    bool checkPrecision();
+
+    int publishFeed();
+
+    int writeSnapshot();
 
 public:
     Simulation(const Inputs &inputs, const ProcessData &process_data);
 
     ~Simulation();
 
-    int run_simulation();
+    Simulation(const Simulation &) = delete;
+
+    Simulation &operator=(const Simulation &) = delete;
+
+    int step(int num_steps);
+
+    int run_simulation(bool report);
+
+    [[nodiscard]] int getTime() const;
+
+    [[nodiscard]] int getLaneOffset() const;
+
+    [[nodiscard]] Span<int8_t> getLaneSpeeds(int lane);
+
+    [[nodiscard]] const Statistic &getTravelTime() const;
+
+    [[nodiscard]] const Statistic &getFlow() const;
+
+    [[nodiscard]] const Statistic &getMeanSpeed() const;
+
+    [[nodiscard]] bool hasResult() const;
+
+    [[nodiscard]] double getResult() const;
 };
 
 
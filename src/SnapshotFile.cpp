@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "SnapshotFile.h"
+
+// Marker at the start of a snapshot file ("CATSSNAP")
+constexpr uint64_t SNAPSHOT_MAGIC = 0x50414e5353544143;
+
+/**
+ * Appends an unsigned number to a buffer in LEB128, seven bits per byte from the lowest, with the high bit of every
+ * byte but the last set
+ * @param value the number
+ * @param buffer pointer to the buffer
+ */
+static void appendVarint(uint64_t value, std::vector<char> *buffer) {
+    while (value >= 0x80) {
+        buffer->push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer->push_back(static_cast<char>(value));
+}
+
+/**
+ * Reads an unsigned number in LEB128 from a buffer
+ * @param data the buffer
+ * @param size the size of the buffer
+ * @param position_ptr pointer to the position of the number in the buffer, moved past it
+ * @param value_ptr pointer to the number
+ * @return 0 if successful, nonzero if the number runs past the end of the buffer
+ */
+static int readVarint(const char *data, const size_t size, size_t *position_ptr, uint64_t *value_ptr) {
+    uint64_t value = 0;
+    for (int shift = 0; *position_ptr < size && shift < 64; shift += 7) {
+        const auto byte = static_cast<uint8_t>(data[(*position_ptr)++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *value_ptr = value;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Constructor for the SnapshotFile, which is neither created nor opened yet
+ * @param process_data the rank and size of the MPI process
+ */
+SnapshotFile::SnapshotFile(const ProcessData &process_data) : process_data(process_data) {
+    this->file = {};
+    this->writing = false;
+    this->header = {};
+    this->end_offset = 0;
+}
+
+/**
+ * Destructor of the SnapshotFile, which closes the file it writes on all the processes together
+ */
+SnapshotFile::~SnapshotFile() {
+    if (this->writing) {
+        this->close();
+    }
+}
+
+/**
+ * Creates the snapshot file shared by all the processes, replacing the one of an earlier simulation. All the processes
+ * must create it together.
+ * @param file_name path and name of the snapshot file
+ * @param num_lanes the number of Lanes
+ * @param interval the number of steps between the snapshots
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::create(const std::string &file_name, const int num_lanes, const int interval) {
+    if (MPI_File_open(MPI_COMM_WORLD, file_name.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                      &this->file) != MPI_SUCCESS) {
+        std::cout << "error: failure to create the \"" << file_name << "\" snapshot file!" << std::endl;
+        return 1;
+    }
+    MPI_File_set_size(this->file, 0);
+    this->writing = true;
+
+    // The header marks the file incomplete until the index is written when it is closed
+    this->header.magic = SNAPSHOT_MAGIC;
+    this->header.num_lanes = num_lanes;
+    this->header.num_processes = this->process_data.getSize();
+    this->header.interval = interval;
+    this->header.num_snapshots = 0;
+    this->header.index_offset = 0;
+    if (this->process_data.getRank() == 0) {
+        MPI_File_write_at(this->file, 0, &this->header, sizeof(SnapshotFileHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    this->end_offset = sizeof(SnapshotFileHeader);
+    this->buffer.assign(sizeof(SnapshotBlockHeader), 0);
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Run-length encodes the speeds of the sites of a Lane into the block of the process of the next snapshot, after the
+ * Lanes encoded before it. The Lanes must be encoded in order, once each.
+ * @param speeds the speeds of the sites of the Lane, -1 for the empty sites
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::encodeLane(const Span<int8_t> &speeds) {
+    const size_t size = speeds.size();
+    int64_t num_vehicles = 0;
+    size_t site = 0;
+    while (site < size) {
+        const int8_t speed = speeds[site];
+        const size_t run_start = site;
+        while (site < size && speeds[site] == speed) {
+            site++;
+        }
+        if (speed >= 0) {
+            num_vehicles += static_cast<int64_t>(site - run_start);
+        }
+        appendVarint(site - run_start, &this->buffer);
+        this->buffer.push_back(static_cast<char>(speed));
+    }
+    auto *block = reinterpret_cast<SnapshotBlockHeader *>(this->buffer.data());
+    block->lane_size = static_cast<int64_t>(size);
+    block->num_vehicles += num_vehicles;
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Writes the blocks of the encoded Lanes of all the processes as the next snapshot, at the offsets that follow from
+ * the sizes of the blocks of the processes of lower rank. All the processes must write the snapshot together.
+ * @param time the simulation time
+ * @param lane_offset the site of the Road at which the Lanes of the process start
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::write(const int64_t time, const int64_t lane_offset) {
+    auto *block = reinterpret_cast<SnapshotBlockHeader *>(this->buffer.data());
+    block->time = time;
+    block->lane_offset = lane_offset;
+
+    // Place the blocks of the processes one after the other, the first process indexing them
+    const int rank = this->process_data.getRank();
+    unsigned long long size = this->buffer.size();
+    std::vector<unsigned long long> sizes(this->process_data.getSize());
+    MPI_Allgather(&size, 1, MPI_UNSIGNED_LONG_LONG, sizes.data(), 1, MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+    int64_t offset = this->end_offset;
+    for (int r = 0; r < this->process_data.getSize(); r++) {
+        if (rank == 0) {
+            this->index.push_back({time, offset, static_cast<int64_t>(sizes[r])});
+        }
+        offset += static_cast<int64_t>(sizes[r]);
+    }
+    int64_t block_offset = this->end_offset;
+    for (int r = 0; r < rank; r++) {
+        block_offset += static_cast<int64_t>(sizes[r]);
+    }
+    this->end_offset = offset;
+    this->header.num_snapshots++;
+
+    // Write the blocks of all the processes together
+    const int status = MPI_File_write_at_all(this->file, block_offset, this->buffer.data(), static_cast<int>(size),
+                                             MPI_BYTE, MPI_STATUS_IGNORE);
+
+    // Start the block of the next snapshot
+    this->buffer.assign(sizeof(SnapshotBlockHeader), 0);
+    if (status != MPI_SUCCESS) {
+        std::cout << "error: failure to write the snapshot at time " << time << "!" << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Closes the snapshot file after the first process appended the index of the blocks and completed the header. All the
+ * processes must close it together.
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::close() {
+    if (this->process_data.getRank() == 0) {
+        this->header.index_offset = this->end_offset;
+        MPI_File_write_at(this->file, this->end_offset, this->index.data(),
+                          static_cast<int>(this->index.size() * sizeof(SnapshotIndexEntry)), MPI_BYTE,
+                          MPI_STATUS_IGNORE);
+        MPI_File_write_at(this->file, 0, &this->header, sizeof(SnapshotFileHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    this->writing = false;
+    if (MPI_File_close(&this->file) != MPI_SUCCESS) {
+        std::cout << "error: failure to close the snapshot file!" << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Opens a complete snapshot file for reading, on a single process
+ * @param file_name path and name of the snapshot file
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::open(const std::string &file_name) {
+    this->input.open(file_name, std::ios::binary);
+    if (!this->input) {
+        std::cout << "error: failure to open the \"" << file_name << "\" snapshot file!" << std::endl;
+        return 1;
+    }
+    this->input.read(reinterpret_cast<char *>(&this->header), sizeof(SnapshotFileHeader));
+    if (!this->input || this->header.magic != SNAPSHOT_MAGIC) {
+        std::cout << "error: \"" << file_name << "\" is not a snapshot file!" << std::endl;
+        return 1;
+    }
+    if (this->header.index_offset == 0) {
+        std::cout << "error: the \"" << file_name << "\" snapshot file has no index, its simulation did not finish!"
+                << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Getter for the number of Lanes of the snapshot file
+ * @return the number of Lanes
+ */
+int SnapshotFile::getNumLanes() const {
+    return this->header.num_lanes;
+}
+
+/**
+ * Getter for the number of processes that wrote the snapshot file
+ * @return the number of processes
+ */
+int SnapshotFile::getNumProcesses() const {
+    return this->header.num_processes;
+}
+
+/**
+ * Getter for the number of snapshots in the snapshot file
+ * @return the number of snapshots
+ */
+int64_t SnapshotFile::getNumSnapshots() const {
+    return this->header.num_snapshots;
+}
+
+/**
+ * Reads the block of a process in the snapshot of a step from the opened file, found through the index: the snapshot
+ * of a step is the step divided by the snapshot interval, as the first snapshot is the initial state
+ * @param time the simulation time of the snapshot
+ * @param rank the rank of the process
+ * @param block_ptr pointer to the header of the block of the process
+ * @param speeds_ptr pointer to the speeds of the sites of each Lane of the process, one Lane after the other
+ * @return 0 if successful, nonzero otherwise
+ */
+int SnapshotFile::read(const int64_t time, const int rank, SnapshotBlockHeader *block_ptr,
+                       std::vector<int8_t> *speeds_ptr) {
+    const int64_t snapshot = time / this->header.interval;
+    if (time < 0 || time % this->header.interval != 0 || snapshot >= this->header.num_snapshots || rank < 0 ||
+        rank >= this->header.num_processes) {
+        std::cout << "error: no snapshot of process " << rank << " at time " << time << "!" << std::endl;
+        return 1;
+    }
+
+    // Look the block up in the index and read it
+    SnapshotIndexEntry entry{};
+    this->input.clear();
+    this->input.seekg(this->header.index_offset + static_cast<int64_t>(sizeof(SnapshotIndexEntry)) *
+                      (snapshot * this->header.num_processes + rank));
+    this->input.read(reinterpret_cast<char *>(&entry), sizeof(SnapshotIndexEntry));
+    std::vector<char> block(std::max<int64_t>(entry.size, sizeof(SnapshotBlockHeader)));
+    this->input.seekg(entry.offset);
+    this->input.read(block.data(), entry.size);
+    if (!this->input || entry.time != time || entry.size < static_cast<int64_t>(sizeof(SnapshotBlockHeader))) {
+        std::cout << "error: the snapshot of process " << rank << " at time " << time << " is corrupt!" << std::endl;
+        return 1;
+    }
+    std::memcpy(block_ptr, block.data(), sizeof(SnapshotBlockHeader));
+
+    // Decode the runs of the speeds of the Lanes
+    const size_t num_sites = static_cast<size_t>(this->header.num_lanes) * block_ptr->lane_size;
+    speeds_ptr->clear();
+    speeds_ptr->reserve(num_sites);
+    size_t position = sizeof(SnapshotBlockHeader);
+    while (speeds_ptr->size() < num_sites) {
+        uint64_t run_length = 0;
+        if (readVarint(block.data(), entry.size, &position, &run_length) != 0 ||
+            position >= static_cast<size_t>(entry.size) || run_length > num_sites - speeds_ptr->size()) {
+            std::cout << "error: the snapshot of process " << rank << " at time " << time << " is corrupt!"
+                    << std::endl;
+            return 1;
+        }
+        speeds_ptr->insert(speeds_ptr->end(), run_length, static_cast<int8_t>(block[position++]));
+    }
+
+    // Return with no errors
+    return 0;
+}
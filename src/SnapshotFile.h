@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_SNAPSHOTFILE_H
+#define CA_TRAFFIC_SIMULATION_SNAPSHOTFILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "ProcessData.h"
+#include "Span.h"
+
+/**
+ * Structure for the header at the start of a snapshot file
+ */
+struct SnapshotFileHeader {
+    uint64_t magic;
+    int32_t num_lanes;
+    int32_t num_processes;
+    int64_t interval;
+    int64_t num_snapshots;
+    int64_t index_offset;
+};
+
+/**
+ * Structure for the start of the block of a process in a snapshot, followed by the runs of the speeds of its Lanes
+ */
+struct SnapshotBlockHeader {
+    int64_t time;
+    int64_t lane_offset;
+    int64_t lane_size;
+    int64_t num_vehicles;
+};
+
+/**
+ * Structure for the entry of the index of a snapshot file with the position of the block of a process in a snapshot
+ */
+struct SnapshotIndexEntry {
+    int64_t time;
+    int64_t offset;
+    int64_t size;
+};
+
+/**
+ * Class for a file of snapshots of the Lanes of all the processes, shared by the processes and written with collective
+ * MPI-IO. Every snapshot holds a block per process, in order of rank, with the time, the sites of the Lanes of the
+ * process and its number of Vehicles, followed by the speeds of the sites of each Lane run-length encoded: pairs of the
+ * length of a run of equal speeds, as an unsigned LEB128 number, and the speed, -1 for the empty sites. The processes
+ * share the sizes of their blocks to place them one after the other, and write them together. The first process
+ * writes the index of the blocks, by snapshot and rank, at the end of the file when it is closed, so that the block
+ * of any process at any step is found without scanning the file.
+ */
+class SnapshotFile {
+    ProcessData process_data;
+    MPI_File file;
+    bool writing;
+    SnapshotFileHeader header;
+    int64_t end_offset;
+    std::vector<SnapshotIndexEntry> index;
+    std::vector<char> buffer;
+    std::ifstream input;
+
+public:
+    explicit SnapshotFile(const ProcessData &process_data);
+
+    ~SnapshotFile();
+
+    int create(const std::string &file_name, int num_lanes, int interval);
+
+    int encodeLane(const Span<int8_t> &speeds);
+
+    int write(int64_t time, int64_t lane_offset);
+
+    int close();
+
+    int open(const std::string &file_name);
+
+    [[nodiscard]] int getNumLanes() const;
+
+    [[nodiscard]] int getNumProcesses() const;
+
+    [[nodiscard]] int64_t getNumSnapshots() const;
+
+    int read(int64_t time, int rank, SnapshotBlockHeader *block_ptr, std::vector<int8_t> *speeds_ptr);
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_SNAPSHOTFILE_H
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_SPAN_H
+#define CA_TRAFFIC_SIMULATION_SPAN_H
+
+#include <cstddef>
+
+/**
+ * Class for a read-only view of a contiguous array owned by another object, which is not copied. The view is only
+ * valid as long as the array is neither modified nor reallocated by its owner.
+ */
+template<typename T>
+class Span {
+    const T *pointer;
+    std::size_t length;
+
+public:
+    Span() : pointer(nullptr), length(0) {
+    }
+
+    Span(const T *pointer, const std::size_t length) : pointer(pointer), length(length) {
+    }
+
+    [[nodiscard]] const T *data() const { return this->pointer; }
+
+    [[nodiscard]] std::size_t size() const { return this->length; }
+
+    [[nodiscard]] bool empty() const { return this->length == 0; }
+
+    [[nodiscard]] const T *begin() const { return this->pointer; }
+
+    [[nodiscard]] const T *end() const { return this->pointer + this->length; }
+
+    const T &operator[](const std::size_t i) const { return this->pointer[i]; }
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_SPAN_H
@@ -3,9 +3,36 @@
  */
 
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include "Statistic.h"
 
+// Number of samples averaged into each batch of the MSER-5 truncation rule
+constexpr int MSER_BATCH_SIZE = 5;
+
+// Number of batches of the batch means confidence intervals and the least number of samples in a batch
+constexpr int NUM_BATCHES = 20;
+constexpr int MIN_BATCH_SIZE = 5;
+
+/**
+ * Gets the 97.5% quantile of the Student t distribution, which gives the half-width of the 95% confidence interval of
+ * an average, from a table for few degrees of freedom and with the Cornish-Fisher expansion around the normal quantile
+ * otherwise (within 0.2% from 5 degrees of freedom up)
+ * @param dof the number of degrees of freedom
+ * @return the quantile
+ */
+static double getTQuantile(const int dof) {
+    constexpr double table[] = {12.706, 4.303, 3.182, 2.776};
+    if (dof <= 4) {
+        return table[dof - 1];
+    }
+    const double z = 1.959964;
+    const double v = dof;
+    return z + (z * z * z + z) / (4.0 * v) + (5.0 * pow(z, 5) + 16.0 * pow(z, 3) + 3.0 * z) / (96.0 * v * v) +
+           (3.0 * pow(z, 7) + 19.0 * pow(z, 5) + 17.0 * pow(z, 3) - 15.0 * z) / (384.0 * v * v * v);
+}
+
 /**
  * Adds a sample to the statistic
  * @param value value of the sample
@@ -20,16 +47,25 @@ void Statistic::addValue(const double value) {
  * @return average of the samples in the Statistic
  */
 double Statistic::getAverage() const {
+    return this->getAverage(0);
+}
+
+/**
+ * Gets the average of the samples in the Statistic after the leading ones
+ * @param first the number of leading samples to leave out
+ * @return average of the samples after the leading ones
+ */
+double Statistic::getAverage(const int first) const {
     // Initialize a sum for the average
     double sum = 0.0;
 
-    // Add each value in the vector of values to the sum
-    for (double const value: this->values) {
-        sum += value;
+    // Add each value in the vector of values after the leading ones to the sum
+    for (int i = first; i < static_cast<int>(this->values.size()); i++) {
+        sum += this->values[i];
     }
 
     // Divide the sum by the number of points and return the average
-    return sum / static_cast<double>(this->values.size());
+    return sum / static_cast<double>(static_cast<int>(this->values.size()) - first);
 }
 
 /**
@@ -59,3 +95,110 @@ double Statistic::getVariance() const {
 int Statistic::getNumSamples() const {
     return static_cast<int>(this->values.size());
 }
+
+/**
+ * Finds the end of the initial transient of the samples with the MSER-5 rule: the samples are averaged in batches of
+ * five, and the leading batches discarded are the ones that minimise the variance of the mean of the remaining batches
+ * divided by their number. The transient is only found once it lies in the first half of the batches, otherwise the
+ * samples have not reached the steady state yet.
+ * @return the number of leading samples of the transient, or -1 if the steady state is not reached yet
+ */
+int Statistic::getTruncationPoint() const {
+    const int num_batches = static_cast<int>(this->values.size()) / MSER_BATCH_SIZE;
+    if (num_batches < 2) {
+        return -1;
+    }
+
+    // Average the samples in batches
+    std::vector<double> batch_means(num_batches, 0.0);
+    for (int j = 0; j < num_batches; j++) {
+        for (int k = 0; k < MSER_BATCH_SIZE; k++) {
+            batch_means[j] += this->values[j * MSER_BATCH_SIZE + k];
+        }
+        batch_means[j] /= MSER_BATCH_SIZE;
+    }
+
+    // Evaluate the statistic of each number of discarded batches from the sums of the batch means after it, keeping at
+    // least two batches
+    double sum = 0.0;
+    double square_sum = 0.0;
+    int best_discarded = num_batches - 2;
+    double best_statistic = std::numeric_limits<double>::max();
+    for (int d = num_batches - 1; d >= 0; d--) {
+        sum += batch_means[d];
+        square_sum += batch_means[d] * batch_means[d];
+        const int remaining = num_batches - d;
+        if (remaining < 2) {
+            continue;
+        }
+        const double statistic = (square_sum - sum * sum / remaining) / (static_cast<double>(remaining) * remaining);
+        if (statistic <= best_statistic) {
+            best_statistic = statistic;
+            best_discarded = d;
+        }
+    }
+
+    if (best_discarded > num_batches / 2) {
+        return -1;
+    }
+    return best_discarded * MSER_BATCH_SIZE;
+}
+
+/**
+ * Gets the half-width of the 95% confidence interval of the average of the samples after the transient, from the
+ * means of a fixed number of batches of consecutive samples, which are nearly independent even when the samples are
+ * correlated
+ * @param first the number of leading samples of the transient
+ * @return the half-width, or infinity if there are too few samples
+ */
+double Statistic::getHalfWidth(const int first) const {
+    const int batch_size = (static_cast<int>(this->values.size()) - first) / NUM_BATCHES;
+    if (batch_size < MIN_BATCH_SIZE) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // Average the samples in batches, leaving out the leftover samples right after the transient
+    const int start = static_cast<int>(this->values.size()) - NUM_BATCHES * batch_size;
+    double sum = 0.0;
+    double square_sum = 0.0;
+    for (int j = 0; j < NUM_BATCHES; j++) {
+        double batch_sum = 0.0;
+        for (int k = 0; k < batch_size; k++) {
+            batch_sum += this->values[start + j * batch_size + k];
+        }
+        const double batch_mean = batch_sum / batch_size;
+        sum += batch_mean;
+        square_sum += batch_mean * batch_mean;
+    }
+    const double variance = std::max(0.0, (square_sum - sum * sum / NUM_BATCHES) / (NUM_BATCHES - 1));
+    return getTQuantile(NUM_BATCHES - 1) * std::sqrt(variance / NUM_BATCHES);
+}
+
+/**
+ * Discards the leading samples of the initial transient
+ * @param first the number of leading samples to discard
+ */
+void Statistic::truncate(const int first) {
+    this->values.erase(this->values.begin(), this->values.begin() + std::min(first, this->getNumSamples()));
+}
+
+/**
+ * Gets the half-width of the 95% confidence interval of the average of the samples, which must be independent, like
+ * the results of independent replicas of a simulation
+ * @return the half-width, or infinity if there are fewer than two samples
+ */
+double Statistic::getConfidenceHalfWidth() const {
+    if (this->values.size() < 2) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return getTQuantile(this->getNumSamples() - 1) * std::sqrt(this->getVariance() / this->getNumSamples());
+}
+
+/**
+ * Getter for a read-only view of the samples of the Statistic, in the order they were added, which is valid until a
+ * sample is added or the Statistic is truncated
+ * @return the samples
+ */
+Span<double> Statistic::getValues() const {
+    return {this->values.data(), this->values.size()};
+}
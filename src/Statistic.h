@@ -7,6 +7,8 @@
 
 #include <vector>
 
+#include "Span.h"
+
 /**
  * Class for the statistics of a property of the simulation, like Vehicle travel time on the road. Has methods for
  * adding samples to the statistic, or getting mean and variance
@@ -23,9 +25,21 @@ public:
 
     [[nodiscard]] double getAverage() const;
 
+    [[nodiscard]] double getAverage(int first) const;
+
     [[nodiscard]] double getVariance() const;
 
     [[nodiscard]] int getNumSamples() const;
+
+    [[nodiscard]] int getTruncationPoint() const;
+
+    [[nodiscard]] double getHalfWidth(int first) const;
+
+    [[nodiscard]] double getConfidenceHalfWidth() const;
+
+    void truncate(int first);
+
+    [[nodiscard]] Span<double> getValues() const;
 };
 
 
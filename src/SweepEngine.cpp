@@ -0,0 +1,751 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include "SweepEngine.h"
+
+/**
+ * Constructor for the SweepEngine
+ * @param inputs instance of the Inputs class with simulation inputs
+ * @param process_data Contains the rank and size of the MPI process, represented
+ *                     by an instance of the `ProcessData` class. This is used to
+ *                     manage distributed simulation across multiple processes.
+ */
+SweepEngine::SweepEngine(const Inputs &inputs, const ProcessData &process_data) : random(inputs) {
+    // Split the sites among the processes in the same way as the Lane class, with the remainder on the last process
+    this->size = inputs.length / process_data.getSize();
+    if (process_data.getRank() == process_data.getSize() - 1) {
+        this->size += inputs.length % process_data.getSize();
+    }
+
+    // Copy the parameters of the CA rules
+    this->num_lanes = inputs.num_lanes;
+    this->max_speed = inputs.max_speed;
+    this->look_other_backward = inputs.look_other_backward;
+    this->passing_rule = inputs.passing_rule;
+    this->prob_slow_down = inputs.prob_slow_down;
+    this->prob_change = inputs.prob_change;
+    this->num_threads = std::max(1, std::min(inputs.num_threads, this->num_lanes));
+    this->periodic = inputs.boundary == BOUNDARY_PERIODIC;
+
+    // The decisions of a site can read up to max_speed + 1 sites downstream, so the commits and moves of the single
+    // sweep lag behind the decisions by max_speed + 2 sites, which are remembered in a ring buffer per Lane. The
+    // passes, used in parallel and on the ring road, need the decisions of the whole Lane instead.
+    this->delay = this->max_speed + 2;
+    const bool passes = this->num_threads > 1 || this->periodic;
+    const int ring_size = passes ? getRingSize(this->size - 1) : getRingSize(this->delay);
+    this->ring_mask = ring_size - 1;
+
+    // Select the single sweep instantiation for the parameters, unless the generic one is requested
+    this->kernel = &SweepEngine::sweep<0, 0>;
+    if (inputs.kernel == 0) {
+        this->kernel = selectKernel(this->max_speed, this->num_lanes);
+    }
+    this->specialised = this->kernel != &SweepEngine::sweep<0, 0>;
+
+    // Allocate the cell arrays of the Lanes, with all sites initially empty. Each array is first written by the thread
+    // that updates its Lane in the parallel passes, so that its pages are placed on the NUMA node of that thread
+    this->huge_pages = inputs.huge_pages;
+    this->speeds.resize(this->num_lanes, LaneVector<int8_t>(LaneAllocator<int8_t>(this->huge_pages)));
+    this->ids.resize(this->num_lanes, LaneVector<int>(LaneAllocator<int>(this->huge_pages)));
+    this->entry_times.resize(this->num_lanes, LaneVector<int>(LaneAllocator<int>(this->huge_pages)));
+    this->intents.resize(this->num_lanes, LaneVector<int8_t>(LaneAllocator<int8_t>(this->huge_pages)));
+    this->chunk_counts.resize(this->num_lanes, LaneVector<int>(LaneAllocator<int>(this->huge_pages)));
+#pragma omp parallel for schedule(static) num_threads(this->num_threads)
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->speeds[i].assign(this->size, -1);
+        this->ids[i].assign(this->size, -1);
+        this->entry_times[i].assign(this->size, 0);
+        this->intents[i].assign(ring_size, -1);
+        this->chunk_counts[i].assign((this->size >> CHUNK_SHIFT) + 1, 0);
+    }
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->switch_generators.emplace_back(static_cast<unsigned int>(std::rand()));
+        this->move_generators.emplace_back(static_cast<unsigned int>(std::rand()));
+    }
+
+    // Gather the cell arrays of each Lane with its right (lower numbered) and left (higher numbered) neighbour, which
+    // are resolved once, -1 at the edges
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->lane_cells.push_back({
+            this->speeds[i].data(), this->ids[i].data(), this->entry_times[i].data(), this->intents[i].data(),
+            this->chunk_counts[i].data(), {i > 0 ? i - 1 : -1, i < this->num_lanes - 1 ? i + 1 : -1}
+        });
+    }
+    this->active_chunks.resize((this->size >> CHUNK_SHIFT) + 1, 0);
+    this->exit_travel_times.resize(this->num_lanes);
+    this->steps_to_spawn.resize(this->num_lanes, 0);
+    this->ahead.resize(this->num_lanes);
+    this->below.resize(this->num_lanes);
+    this->next_moved.resize(this->num_lanes);
+    this->first_sites.resize(this->num_lanes);
+    this->last_sites.resize(this->num_lanes);
+    this->wrapped_vehicles.resize(this->num_lanes);
+    this->speed_sums.resize(this->num_lanes, 0);
+
+    this->demand = new Demand(inputs);
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->steps_to_spawn[i] = this->demand->getInitialStepsToSpawn(i);
+    }
+}
+
+/**
+ * Destructor of the SweepEngine
+ */
+SweepEngine::~SweepEngine() {
+    delete this->demand;
+}
+
+/**
+ * Draws a uniform random number in [0, 1] from a random number generator
+ * @param generator the random number generator
+ * @return the random number
+ */
+double SweepEngine::draw(std::mt19937 &generator) {
+    return static_cast<double>(generator()) / static_cast<double>(std::mt19937::max());
+}
+
+/**
+ * Draws the uniform random number of an event of a Vehicle, keyed by its id and age when the simulation has a seed and
+ * drawn from a random number generator of its Lane otherwise
+ * @param generator the random number generator
+ * @param id the id of the Vehicle
+ * @param age the number of steps the Vehicle was on the Road at the start of the step
+ * @param stream the kind of the event
+ * @return the random number
+ */
+double SweepEngine::drawEvent(std::mt19937 &generator, const int id, const int age, const int stream) const {
+    if (this->random.isEnabled()) {
+        return this->random.draw(id, age, stream);
+    }
+    return draw(generator);
+}
+
+/**
+ * Decides whether the Vehicle in an occupied site switches Lane, based on the configuration before the lane switches, and records
+ * the Lane it switches to in the decisions of the Lane, which are -1 for all the other sites. The left
+ * Lane is preferred over the right one. With the symmetric rule the Vehicle only switches if it is blocked in its Lane,
+ * while with the asymmetric rule it only passes on the left and returns to the right Lane whenever there is room.
+ * @tparam VMAX the maximum speed, or 0 to read it at run time
+ * @param cells the cell arrays of the Lanes
+ * @param lane the number of the Lane
+ * @param site the site of the Lane
+ * @param time the simulation time at the start of the step
+ * @param ahead_sites the nearest occupied site downstream of the site in each Lane, -1 if there is none, beyond the end of
+ *                    the Lane on the ring road
+ * @param below_sites the last located occupied site upstream of a site in each Lane, relocated when stale
+ */
+template<int VMAX>
+void SweepEngine::decide(const LaneCells *cells, const int lane, const int site, const int time, const int *ahead_sites,
+                         int *below_sites) {
+    const int speed = cells[lane].speeds[site];
+
+    // Gap to the preceding Vehicle in the Lane, the Lane size minus one if there is none like in the Vehicle class
+    const int look = speed + 1;
+    const int gap_forward = ahead_sites[lane] < 0 ? this->size - 1 : ahead_sites[lane] - site - 1;
+    const bool blocked = gap_forward < look;
+
+    int target = -1;
+    for (int side = SIDE_LEFT; side >= SIDE_RIGHT && target < 0; side--) {
+        const int other = cells[lane].neighbours[side];
+        if (other < 0 || cells[other].speeds[site] >= 0) {
+            continue;
+        }
+        if (!blocked && !(this->passing_rule == PASSING_ASYMMETRIC && side == SIDE_RIGHT)) {
+            continue;
+        }
+
+        // Forward gap in the other Lane, whose site next to the Vehicle is known to be empty
+        const int gap_other_forward = ahead_sites[other] < 0 ? this->size - 1 : ahead_sites[other] - site - 1;
+        if (gap_other_forward <= look) {
+            continue;
+        }
+
+        // Backward gap in the other Lane, locating the nearest occupied site behind only when the tracked one is stale
+        int &behind = below_sites[other];
+        if (behind >= site) {
+            behind = site - 1;
+            while (behind >= 0 && cells[other].speeds[behind] < 0) {
+                behind--;
+            }
+        }
+        int gap_other_backward = behind < 0 ? this->size - 1 : site - behind - 1;
+        if (VMAX == 0 && this->periodic && behind < 0 && this->last_sites[other] >= 0) {
+            // On the ring road the nearest Vehicle behind is the most downstream one of the other Lane
+            gap_other_backward = site + this->size - this->last_sites[other] - 1;
+        }
+        if (gap_other_backward <= this->look_other_backward) {
+            continue;
+        }
+
+        target = other;
+    }
+
+    if (target >= 0 && this->drawEvent(this->switch_generators[lane], cells[lane].ids[site],
+                                       time - cells[lane].entry_times[site], STREAM_SWITCH) <= this->prob_change) {
+        const int ring_mask = VMAX > 0 ? getRingSize(VMAX + 2) - 1 : this->ring_mask;
+        cells[lane].intents[site & ring_mask] = static_cast<int8_t>(target);
+    }
+}
+
+/**
+ * Commits the lane switch decided for the Vehicle in a site. Two Vehicles can only target the same site from
+ * both sides of a Lane, in which case the one switching from the lower numbered Lane has priority. The decision is
+ * cleared separately, once the commits of the site are done in all the Lanes.
+ * @tparam VMAX the maximum speed, or 0 to read it at run time
+ * @param cells the cell arrays of the Lanes
+ * @param lane the number of the Lane
+ * @param site the site of the Lane
+ */
+template<int VMAX>
+void SweepEngine::commit(const LaneCells *cells, const int lane, const int site) const {
+    const int ring_mask = VMAX > 0 ? getRingSize(VMAX + 2) - 1 : this->ring_mask;
+    const int target = cells[lane].intents[site & ring_mask];
+    if (target < lane && target > 0 && cells[target - 1].intents[site & ring_mask] == target) {
+        return;
+    }
+
+#ifdef DEBUG
+    std::cout << "vehicle " << cells[lane].ids[site] << " switched lane " << lane << " -> " << target << std::endl;
+#endif
+
+    cells[target].speeds[site] = cells[lane].speeds[site];
+    cells[target].ids[site] = cells[lane].ids[site];
+    cells[target].entry_times[site] = cells[lane].entry_times[site];
+    cells[lane].speeds[site] = -1;
+}
+
+/**
+ * Moves the Vehicle in an occupied site of a Lane according to its speed, after all the Vehicles downstream of it have moved
+ * @tparam VMAX the maximum speed, or 0 to read it at run time
+ * @param cells the cell arrays of the Lanes
+ * @param lane the number of the Lane
+ * @param site the site of the Lane
+ * @param time the simulation time at the start of the step
+ * @param next_moved_sites the site of the last moved Vehicle before its move in each Lane, -1 if there is none, beyond the
+ *                         end of the Lane on the ring road
+ */
+template<int VMAX>
+void SweepEngine::move(const LaneCells *cells, const int lane, const int site, const int time,
+                       int *next_moved_sites) {
+    const int max_speed = VMAX > 0 ? VMAX : this->max_speed;
+    int8_t *lane_speeds = cells[lane].speeds;
+    int speed = lane_speeds[site];
+
+    // Gap to the position of the preceding Vehicle before it moved
+    const int gap_forward = next_moved_sites[lane] < 0 ? this->size - 1 : next_moved_sites[lane] - site - 1;
+    next_moved_sites[lane] = site;
+
+    // Update Vehicle speed based on vehicle speed update rules
+    if (speed != max_speed) {
+        speed++;
+    }
+    speed = std::min(speed, gap_forward);
+    if (speed > 0 && this->drawEvent(this->move_generators[lane], cells[lane].ids[site],
+                                     time - cells[lane].entry_times[site], STREAM_SLOW_DOWN) <= this->prob_slow_down) {
+        speed--;
+    }
+
+    if (VMAX == 0 && this->periodic) {
+        this->speed_sums[lane] += speed;
+    }
+
+    if (speed == 0) {
+        lane_speeds[site] = 0;
+        return;
+    }
+
+    // If the vehicle reached the end of the road, remove the Vehicle from the Lane and record the time on road
+    const int new_site = site + speed;
+    lane_speeds[site] = -1;
+    if (new_site >= this->size || (site >> CHUNK_SHIFT) != (new_site >> CHUNK_SHIFT)) {
+        cells[lane].chunk_counts[site >> CHUNK_SHIFT]--;
+        if (new_site < this->size) {
+            cells[lane].chunk_counts[new_site >> CHUNK_SHIFT]++;
+        }
+    }
+    if (new_site >= this->size) {
+        // On the ring road the Vehicle continues from the start of the Lane once the moves of the Lane are done
+        if (VMAX == 0 && this->periodic) {
+            this->wrapped_vehicles[lane].push_back({
+                new_site - this->size, static_cast<int8_t>(speed), cells[lane].ids[site], cells[lane].entry_times[site]
+            });
+            return;
+        }
+#ifdef DEBUG
+        std::cout << "vehicle " << cells[lane].ids[site] << " spent " << time + 1 - cells[lane].entry_times[site]
+                << " steps on the road" << std::endl;
+#endif
+        this->exit_travel_times[lane].push_back(time + 1 - cells[lane].entry_times[site]);
+        return;
+    }
+
+    lane_speeds[new_site] = static_cast<int8_t>(speed);
+    cells[lane].ids[new_site] = cells[lane].ids[site];
+    cells[lane].entry_times[new_site] = cells[lane].entry_times[site];
+}
+
+/**
+ * Performs the lane switches and lane moves of a time step in a single sweep over the cell arrays of all the Lanes
+ * @tparam VMAX the maximum speed, or 0 to read it at run time
+ * @tparam NLANES the number of Lanes, or 0 to read it at run time
+ * @param time the simulation time at the start of the step
+ * @return 0 if successful, nonzero otherwise
+ */
+template<int VMAX, int NLANES>
+int SweepEngine::sweep(const int time) {
+    const int num_lanes = NLANES > 0 ? NLANES : this->num_lanes;
+    const int delay = VMAX > 0 ? VMAX + 2 : this->delay;
+    const int ring_mask = VMAX > 0 ? getRingSize(delay) - 1 : this->ring_mask;
+
+    // The specialised instantiations keep the cell arrays and the trackers of the nearest occupied sites in local
+    // arrays, which the writes to the cells cannot alias
+    const LaneCells *cells = this->lane_cells.data();
+    int *ahead_sites = this->ahead.data();
+    int *below_sites = this->below.data();
+    int *next_moved_sites = this->next_moved.data();
+    std::array<LaneCells, NLANES> local_cells;
+    std::array<int, NLANES> local_ahead_sites;
+    std::array<int, NLANES> local_below_sites;
+    std::array<int, NLANES> local_next_moved_sites;
+    if constexpr (NLANES > 0) {
+        std::copy(this->lane_cells.begin(), this->lane_cells.end(), local_cells.begin());
+        cells = local_cells.data();
+        ahead_sites = local_ahead_sites.data();
+        below_sites = local_below_sites.data();
+        next_moved_sites = local_next_moved_sites.data();
+    }
+
+    // Reset the trackers of the nearest occupied sites
+    for (int i = 0; i < num_lanes; i++) {
+        ahead_sites[i] = -1;
+        below_sites[i] = this->size;
+        next_moved_sites[i] = -1;
+    }
+
+    const uint8_t *active = this->active_chunks.data();
+    for (int site = this->size - 1; site >= -delay; site--) {
+        // Skip the rest of an empty chunk once the lagged site is in it too
+        if (site >= 0 && (site & (CHUNK_SIZE - 1)) == CHUNK_SIZE - 1 - delay && !active[site >> CHUNK_SHIFT]) {
+            site &= ~(CHUNK_SIZE - 1);
+            continue;
+        }
+
+        // Decide the lane switches of the site, then mark its occupied sites as the nearest ones ahead of the next site
+        if (site >= 0) {
+            for (int i = 0; i < num_lanes; i++) {
+                if (cells[i].speeds[site] >= 0) {
+                    this->decide<VMAX>(cells, i, site, time, ahead_sites, below_sites);
+                }
+            }
+            for (int i = 0; i < num_lanes; i++) {
+                if (cells[i].speeds[site] >= 0) {
+                    ahead_sites[i] = site;
+                }
+            }
+        }
+
+        // Commit the switches and perform the moves of the site that no pending decision can read anymore
+        if (const int lagged = site + delay; lagged < this->size) {
+            for (int i = 0; i < num_lanes; i++) {
+                if (cells[i].intents[lagged & ring_mask] >= 0) {
+                    this->commit<VMAX>(cells, i, lagged);
+                }
+            }
+            for (int i = 0; i < num_lanes; i++) {
+                cells[i].intents[lagged & ring_mask] = -1;
+            }
+            for (int i = 0; i < num_lanes; i++) {
+                if (cells[i].speeds[lagged] >= 0) {
+                    this->move<VMAX>(cells, i, lagged, time, next_moved_sites);
+                }
+            }
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Selects the single sweep instantiation for a maximum speed, for a given number of Lanes
+ * @tparam NLANES the number of Lanes
+ * @param max_speed the maximum speed
+ * @return the specialised single sweep, or the generic one if there is no instantiation for the maximum speed
+ */
+template<int NLANES>
+SweepEngine::Kernel SweepEngine::selectKernel(const int max_speed) {
+    switch (max_speed) {
+        case 1: return &SweepEngine::sweep<1, NLANES>;
+        case 2: return &SweepEngine::sweep<2, NLANES>;
+        case 3: return &SweepEngine::sweep<3, NLANES>;
+        case 4: return &SweepEngine::sweep<4, NLANES>;
+        case 5: return &SweepEngine::sweep<5, NLANES>;
+        case 6: return &SweepEngine::sweep<6, NLANES>;
+        case 7: return &SweepEngine::sweep<7, NLANES>;
+        case 8: return &SweepEngine::sweep<8, NLANES>;
+        default: return &SweepEngine::sweep<0, 0>;
+    }
+}
+
+/**
+ * Selects the single sweep instantiation for a maximum speed and number of Lanes
+ * @param max_speed the maximum speed
+ * @param num_lanes the number of Lanes
+ * @return the specialised single sweep, or the generic one if there is no instantiation for the parameters
+ */
+SweepEngine::Kernel SweepEngine::selectKernel(const int max_speed, const int num_lanes) {
+    switch (num_lanes) {
+        case 2: return selectKernel<2>(max_speed);
+        case 3: return selectKernel<3>(max_speed);
+        case 4: return selectKernel<4>(max_speed);
+        default: return &SweepEngine::sweep<0, 0>;
+    }
+}
+
+/**
+ * Performs the lane switches and lane moves of a time step with the Lanes updated in parallel, in three passes
+ * separated by barriers: the decisions of all the sites, the commits of the switches, and the moves, which also clear
+ * the decisions. During the commits a Lane only writes its own occupied sites and the empty sites of its neighbours
+ * that it won. On the ring road the gaps of the most downstream Vehicles of each Lane extend past the end of the Lane
+ * to the most upstream Vehicles, which are located before each pass.
+ * @param time the simulation time at the start of the step
+ * @return 0 if successful, nonzero otherwise
+ */
+int SweepEngine::sweepPasses(const int time) {
+    const LaneCells *cells = this->lane_cells.data();
+
+#pragma omp parallel num_threads(this->num_threads)
+    {
+        // Each Lane tracks the nearest occupied sites of itself and its neighbours on its own
+        std::vector<int> ahead_sites(this->num_lanes);
+        std::vector<int> below_sites(this->num_lanes);
+
+        if (this->periodic) {
+#pragma omp for schedule(static)
+            for (int i = 0; i < this->num_lanes; i++) {
+                this->locateEnds(i);
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < this->num_lanes; i++) {
+            std::fill(ahead_sites.begin(), ahead_sites.end(), -1);
+            std::fill(below_sites.begin(), below_sites.end(), this->size);
+            if (this->periodic) {
+                for (int lane = 0; lane < this->num_lanes; lane++) {
+                    ahead_sites[lane] = this->first_sites[lane] < 0 ? -1 : this->first_sites[lane] + this->size;
+                }
+            }
+            for (int site = this->size - 1; site >= 0; site--) {
+                if ((site & (CHUNK_SIZE - 1)) == CHUNK_SIZE - 1 && !this->active_chunks[site >> CHUNK_SHIFT]) {
+                    site &= ~(CHUNK_SIZE - 1);
+                    continue;
+                }
+                if (cells[i].speeds[site] >= 0) {
+                    this->decide<0>(cells, i, site, time, ahead_sites.data(), below_sites.data());
+                }
+                for (const int lane: {i, cells[i].neighbours[SIDE_RIGHT], cells[i].neighbours[SIDE_LEFT]}) {
+                    if (lane >= 0 && cells[lane].speeds[site] >= 0) {
+                        ahead_sites[lane] = site;
+                    }
+                }
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < this->num_lanes; i++) {
+            for (int site = this->size - 1; site >= 0; site--) {
+                if ((site & (CHUNK_SIZE - 1)) == CHUNK_SIZE - 1 && !this->active_chunks[site >> CHUNK_SHIFT]) {
+                    site &= ~(CHUNK_SIZE - 1);
+                    continue;
+                }
+                if (cells[i].intents[site] >= 0) {
+                    this->commit<0>(cells, i, site);
+                }
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < this->num_lanes; i++) {
+            this->next_moved[i] = -1;
+            if (this->periodic) {
+                this->locateEnds(i);
+                this->next_moved[i] = this->first_sites[i] < 0 ? -1 : this->first_sites[i] + this->size;
+            }
+            for (int site = this->size - 1; site >= 0; site--) {
+                if ((site & (CHUNK_SIZE - 1)) == CHUNK_SIZE - 1 && !this->active_chunks[site >> CHUNK_SHIFT]) {
+                    site &= ~(CHUNK_SIZE - 1);
+                    continue;
+                }
+                cells[i].intents[site] = -1;
+                if (cells[i].speeds[site] >= 0) {
+                    this->move<0>(cells, i, site, time, this->next_moved.data());
+                }
+            }
+
+            // Place the Vehicles that wrapped around to the start of the Lane
+            for (const WrappedVehicle &vehicle: this->wrapped_vehicles[i]) {
+                cells[i].chunk_counts[vehicle.site >> CHUNK_SHIFT]++;
+                cells[i].speeds[vehicle.site] = vehicle.speed;
+                cells[i].ids[vehicle.site] = vehicle.id;
+                cells[i].entry_times[vehicle.site] = vehicle.entry_time;
+            }
+        }
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Locates the most upstream and most downstream occupied sites of a Lane, -1 if the Lane is empty
+ * @param lane the number of the Lane
+ */
+void SweepEngine::locateEnds(const int lane) {
+    const LaneVector<int8_t> &lane_speeds = this->speeds[lane];
+    this->first_sites[lane] = -1;
+    this->last_sites[lane] = -1;
+    for (int site = 0; site < this->size; site++) {
+        if (lane_speeds[site] >= 0) {
+            this->first_sites[lane] = site;
+            break;
+        }
+    }
+    for (int site = this->size - 1; site >= 0; site--) {
+        if (lane_speeds[site] >= 0) {
+            this->last_sites[lane] = site;
+            break;
+        }
+    }
+}
+
+/**
+ * Marks the chunks of sites that have a Vehicle in any Lane at the start of a step, which are the only ones the sweeps
+ * visit. The counts of a chunk are summed over the Lanes, since a Vehicle that switched Lanes is still counted in its
+ * previous Lane and the count of its new Lane goes below zero when it leaves the chunk.
+ */
+void SweepEngine::markActiveChunks() {
+    for (size_t c = 0; c < this->active_chunks.size(); c++) {
+        int count = 0;
+        for (const auto &lane_chunk_counts: this->chunk_counts) {
+            count += lane_chunk_counts[c];
+        }
+        this->active_chunks[c] = count != 0;
+    }
+}
+
+/**
+ * Performs the lane switches and lane moves of a time step
+ * @param time the simulation time at the start of the step
+ * @param travel_times pointer to the list to append the travel times (in steps) of the Vehicles leaving the Road to
+ * @return 0 if successful, nonzero otherwise
+ */
+int SweepEngine::step(const int time, std::vector<int> *travel_times) {
+    for (int i = 0; i < this->num_lanes; i++) {
+        this->wrapped_vehicles[i].clear();
+        this->speed_sums[i] = 0;
+    }
+
+    this->markActiveChunks();
+    if (this->num_threads > 1 || this->periodic) {
+        this->sweepPasses(time);
+    } else {
+        (this->*kernel)(time);
+    }
+
+    // Collect the travel times Lane after Lane, so that the order does not depend on the number of threads
+    for (auto &lane_travel_times: this->exit_travel_times) {
+        travel_times->insert(travel_times->end(), lane_travel_times.begin(), lane_travel_times.end());
+        lane_travel_times.clear();
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Attempts to spawn a Vehicle at the first site of each Lane, in the same way as the Lane class
+ * @param time the simulation time, recorded as the entry time of the spawned Vehicles
+ * @param next_id_ptr pointer to the id number of the next spawned Vehicle
+ * @return 0 if successful, nonzero otherwise
+ */
+int SweepEngine::attemptSpawn(const int time, int *next_id_ptr) {
+    for (int i = 0; i < this->num_lanes; i++) {
+        if (this->steps_to_spawn[i] == 0) {
+            if (this->speeds[i][0] < 0) {
+#ifdef DEBUG
+                std::cout << "creating vehicle " << (*next_id_ptr) << " in lane " << i << " at site " << 0
+                        << std::endl;
+#endif
+                this->speeds[i][0] = static_cast<int8_t>(this->max_speed);
+                this->chunk_counts[i][0]++;
+                this->ids[i][0] = (*next_id_ptr)++;
+                this->entry_times[i][0] = time;
+
+                // Randomly choose the Vehicles initial speed to be zero bases in slow down probability
+                const double u = this->random.isEnabled()
+                                     ? this->random.draw(this->ids[i][0], 0, STREAM_SPAWN_SPEED)
+                                     : static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+                if (u < this->prob_slow_down) {
+                    this->speeds[i][0] = 0;
+                }
+
+                // "Schedule" next Vehicle spawn
+                this->steps_to_spawn[i] = this->demand->drawStepsToSpawn(i, time);
+            }
+        } else {
+            this->steps_to_spawn[i]--;
+        }
+    }
+
+    // Return with no error
+    return 0;
+}
+
+/**
+ * Populates the ring road with its fixed number of Vehicles in the same way as the Road class, placed in random distinct
+ * sites and initially stopped
+ * @param percent_full the fraction of the sites of the Road that are occupied
+ * @param next_id_ptr pointer to the id number of the next placed Vehicle
+ * @return 0 if successful, nonzero otherwise
+ */
+int SweepEngine::populate(const double percent_full, int *next_id_ptr) {
+    const int num_sites = this->num_lanes * this->size;
+    const int num_vehicles = std::min(num_sites, static_cast<int>(num_sites * percent_full + 0.5));
+
+    // Draw the occupied sites with a partial Fisher-Yates shuffle of all the sites of the Road
+    std::vector<int> sites(num_sites);
+    for (int i = 0; i < num_sites; i++) {
+        sites[i] = i;
+    }
+    for (int i = 0; i < num_vehicles; i++) {
+        const int pick = this->random.isEnabled() ? this->random.drawIndex(0, i, STREAM_POPULATE, num_sites - i)
+                                                  : std::rand() % (num_sites - i);
+        std::swap(sites[i], sites[i + pick]);
+    }
+
+    // Number the Vehicles Lane after Lane in order of decreasing position
+    const int size = this->size;
+    std::sort(sites.begin(), sites.begin() + num_vehicles, [size](const int a, const int b) {
+        return a / size != b / size ? a / size < b / size : a % size > b % size;
+    });
+    for (int i = 0; i < num_vehicles; i++) {
+        const int lane = sites[i] / size;
+        const int site = sites[i] % size;
+        this->speeds[lane][site] = 0;
+        this->chunk_counts[lane][site >> CHUNK_SHIFT]++;
+        this->ids[lane][site] = (*next_id_ptr)++;
+        this->entry_times[lane][site] = 0;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Counts the Vehicles in all the Lanes
+ * @return number of Vehicles on the Road
+ */
+int SweepEngine::getNumVehicles() const {
+    int count = 0;
+    for (const auto &lane: this->speeds) {
+        count += static_cast<int>(std::count_if(lane.begin(), lane.end(), [](const int8_t speed) {
+            return speed >= 0;
+        }));
+    }
+    return count;
+}
+
+/**
+ * Checks whether the single sweep of the SweepEngine is specialised at compile time for its parameters
+ * @return whether the specialised single sweep is used
+ */
+bool SweepEngine::isSpecialised() const {
+    return this->specialised && this->num_threads == 1 && !this->periodic;
+}
+
+/**
+ * Counts the Vehicles that wrapped around from the end to the start of their Lane of the ring road in the last step
+ * @return the number of Vehicles that wrapped around
+ */
+int SweepEngine::getNumWrapped() const {
+    int count = 0;
+    for (const auto &lane_wrapped_vehicles: this->wrapped_vehicles) {
+        count += static_cast<int>(lane_wrapped_vehicles.size());
+    }
+    return count;
+}
+
+/**
+ * Sums the speeds of all the Vehicles of the ring road after the moves of the last step
+ * @return the sum of the speeds
+ */
+long SweepEngine::getSpeedSum() const {
+    long sum = 0;
+    for (const long lane_speed_sum: this->speed_sums) {
+        sum += lane_speed_sum;
+    }
+    return sum;
+}
+
+/**
+ * Counts the chunks of sites that the sweeps of the last step visited, those with a Vehicle in any Lane at its start
+ * @return the number of active chunks
+ */
+int SweepEngine::getNumActiveChunks() const {
+    return static_cast<int>(std::count(this->active_chunks.begin(), this->active_chunks.end(), 1));
+}
+
+/**
+ * Debug function to print the Lanes to visualize the sites
+ */
+#ifdef DEBUG
+void SweepEngine::printLanes() const {
+    for (int i = this->num_lanes - 1; i >= 0; i--) {
+        std::ostringstream lane_string_stream;
+        for (int j = 0; j < this->size; j++) {
+            if (this->speeds[i][j] < 0) {
+                lane_string_stream << "[   ]";
+            } else {
+                lane_string_stream << "[" << std::setw(3) << this->ids[i][j] << "]";
+            }
+        }
+        std::cout << lane_string_stream.str() << std::endl;
+    }
+}
+#endif
+
+/**
+ * Getter for a read-only view of the speeds of the cells of a Lane, -1 for the empty sites, which is valid until the
+ * next step
+ * @param lane the number of the Lane
+ * @return the speeds of the sites of the Lane
+ */
+Span<int8_t> SweepEngine::getLaneSpeeds(const int lane) const {
+    return {this->speeds[lane].data(), static_cast<size_t>(this->size)};
+}
+
+/**
+ * Prints the NUMA locality of the cell arrays of the Lanes for the threads updating them, and their huge pages
+ * @return 0 if successful, nonzero otherwise
+ */
+int SweepEngine::printMemoryLocality() const {
+    std::vector<std::vector<std::pair<const void *, size_t> > > lane_arrays(this->num_lanes);
+    for (int i = 0; i < this->num_lanes; i++) {
+        lane_arrays[i] = {
+            {this->speeds[i].data(), this->speeds[i].size() * sizeof(int8_t)},
+            {this->ids[i].data(), this->ids[i].size() * sizeof(int)},
+            {this->entry_times[i].data(), this->entry_times[i].size() * sizeof(int)},
+            {this->intents[i].data(), this->intents[i].size() * sizeof(int8_t)},
+            {this->chunk_counts[i].data(), this->chunk_counts[i].size() * sizeof(int)}
+        };
+    }
+    return ::printMemoryLocality(lane_arrays, this->num_threads, this->huge_pages);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#ifndef CA_TRAFFIC_SIMULATION_SWEEPENGINE_H
+#define CA_TRAFFIC_SIMULATION_SWEEPENGINE_H
+
+#include <vector>
+#include <array>
+#include <random>
+#include <cstdint>
+
+#include "Inputs.h"
+#include "Demand.h"
+#include "KeyedRandom.h"
+#include "LaneMemory.h"
+#include "ProcessData.h"
+#include "Span.h"
+
+/**
+ * Pointers to the cell arrays of a Lane and the numbers of its right and left neighbour Lanes (-1 at the edges of the
+ * Road), gathered so that the step kernels can copy them to local storage that the cell writes cannot alias. The chunk
+ * counts of a Lane are only updated by the moves, spawns and exits of its own Vehicles, so that the Lanes can update
+ * them in parallel, and the Vehicles that switched to it are still counted in their previous Lane: only their sums over
+ * the Lanes are the numbers of Vehicles in the chunks.
+ */
+struct LaneCells {
+    int8_t *speeds;
+    int *ids;
+    int *entry_times;
+    int8_t *intents;
+    int *chunk_counts;
+    std::array<int, 2> neighbours;
+};
+
+/**
+ * A Vehicle that wrapped around from the end to the start of a Lane of the ring road during the moves of a step, held
+ * back until the moves of its Lane are done so that it is not moved twice
+ */
+struct WrappedVehicle {
+    int site;
+    int8_t speed;
+    int id;
+    int entry_time;
+};
+
+/**
+ * Class for the fused lane-sweep step engine. The Vehicles are stored directly in per-Lane cell arrays (speed, id and
+ * entry time of the Vehicle in each site) and a whole time step, i.e. the gap computation, the lane switches and the
+ * lane moves of the Rickert lane rules, is performed in a single downstream to upstream sweep over the cells.
+ *
+ * The lane switch decision of the site p only reads the configuration before the switches, while the commits of the
+ * switches and the lane moves are delayed until the sweep is far enough upstream (max_speed + 2 sites) that none of the
+ * remaining decisions can read the sites they modify. The gaps are tracked incrementally during the sweep, so there
+ * are no per Vehicle scans of the Lanes.
+ *
+ * The single sweep is a template over the maximum speed and the number of Lanes, so that the ring buffer indexing, the
+ * speed rules and the loops over the Lanes are resolved at compile time. It is instantiated for the maximum speeds 1 to
+ * 8 with 2 to 4 Lanes, and a generic instantiation reading the parameters at run time is used for the other cases.
+ *
+ * The sweeps skip the chunks of CHUNK_SIZE sites that had no Vehicle in any Lane at the start of the step, since none of
+ * their decisions, commits or moves has anything to do, so that the cost of a step follows the number of Vehicles
+ * rather than the length of the Road at low densities.
+ *
+ * With more than one thread, the Lanes are updated in parallel in three passes instead (decisions, commits, moves),
+ * each Lane drawing its lane switch and lane move random numbers from its own two generators in the same order as the
+ * single sweep, so that both produce the same simulation. The three passes are also used on the ring road, where the
+ * gaps of the most downstream Vehicles depend on the most upstream ones and the single sweep does not apply.
+ */
+class SweepEngine {
+    int num_lanes;
+    int size;
+    int max_speed;
+    int look_other_backward;
+    int passing_rule;
+    int num_threads;
+    bool periodic;
+    int delay;
+    int ring_mask;
+    double prob_slow_down;
+    double prob_change;
+    int huge_pages;
+    std::vector<LaneVector<int8_t> > speeds;
+    std::vector<LaneVector<int> > ids;
+    std::vector<LaneVector<int> > entry_times;
+    std::vector<LaneVector<int8_t> > intents;
+    std::vector<LaneVector<int> > chunk_counts;
+    std::vector<uint8_t> active_chunks;
+    std::vector<LaneCells> lane_cells;
+    std::vector<std::vector<int> > exit_travel_times;
+    std::vector<int> steps_to_spawn;
+    std::vector<std::mt19937> switch_generators;
+    std::vector<std::mt19937> move_generators;
+    KeyedRandom random;
+    std::vector<int> ahead;
+    std::vector<int> below;
+    std::vector<int> next_moved;
+    std::vector<int> first_sites;
+    std::vector<int> last_sites;
+    std::vector<std::vector<WrappedVehicle> > wrapped_vehicles;
+    std::vector<long> speed_sums;
+    Demand *demand;
+
+    using Kernel = int (SweepEngine::*)(int);
+    Kernel kernel;
+    bool specialised;
+
+    static constexpr int getRingSize(const int delay) {
+        int ring_size = 1;
+        while (ring_size <= delay) {
+            ring_size *= 2;
+        }
+        return ring_size;
+    }
+
+    static double draw(std::mt19937 &generator);
+
+    [[nodiscard]] double drawEvent(std::mt19937 &generator, int id, int age, int stream) const;
+
+    template<int VMAX>
+    void decide(const LaneCells *cells, int lane, int site, int time, const int *ahead_sites, int *below_sites);
+
+    template<int VMAX>
+    void commit(const LaneCells *cells, int lane, int site) const;
+
+    template<int VMAX>
+    void move(const LaneCells *cells, int lane, int site, int time, int *next_moved_sites);
+
+    template<int VMAX, int NLANES>
+    int sweep(int time);
+
+    template<int NLANES>
+    static Kernel selectKernel(int max_speed);
+
+    static Kernel selectKernel(int max_speed, int num_lanes);
+
+    void locateEnds(int lane);
+
+    void markActiveChunks();
+
+    int sweepPasses(int time);
+
+public:
+    SweepEngine(const Inputs &inputs, const ProcessData &process_data);
+
+    ~SweepEngine();
+
+    int step(int time, std::vector<int> *travel_times);
+
+    int attemptSpawn(int time, int *next_id_ptr);
+
+    int populate(double percent_full, int *next_id_ptr);
+
+    [[nodiscard]] int getNumVehicles() const;
+
+    [[nodiscard]] bool isSpecialised() const;
+
+    [[nodiscard]] int getNumWrapped() const;
+
+    [[nodiscard]] long getSpeedSum() const;
+
+    [[nodiscard]] int getNumActiveChunks() const;
+
+    [[nodiscard]] Span<int8_t> getLaneSpeeds(int lane) const;
+
+    int printMemoryLocality() const;
+
+#ifdef DEBUG
+    void printLanes() const;
+#endif
+};
+
+
+#endif //CA_TRAFFIC_SIMULATION_SWEEPENGINE_H
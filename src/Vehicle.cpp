@@ -2,6 +2,7 @@
  * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <iomanip>
 
@@ -15,19 +16,27 @@
  * @param id unique ID number of the Vehicle
  * @param initial_position initial site number of the Vehicle in the Lane
  * @param inputs instance of the Inputs class with the simulation inputs
+ * @param vehicle_class the number of the class of the Vehicle among the Vehicle classes of the inputs, 0 without classes
  */
-Vehicle::Vehicle(Lane *lane_ptr, const int id, const int initial_position, const Inputs &inputs) {
+Vehicle::Vehicle(Lane *lane_ptr, const int id, const int initial_position, const Inputs &inputs,
+                 const int vehicle_class) : random(inputs) {
     // Set the ID number of the Vehicle
     this->id = id;
 
+    // Set the class of the Vehicle, whose parameters replace the ones of the inputs
+    this->vehicle_class = vehicle_class;
+    const VehicleClass *class_ptr = inputs.vehicle_classes.empty() ? nullptr : &inputs.vehicle_classes[vehicle_class];
+    this->length = class_ptr != nullptr ? class_ptr->length : 1;
+
     // Set the initial position of the Vehicle
     this->position = initial_position;
 
     // Set the Lane pointer to the pointer to the Lane that contains the Vehicle
     this->lane_ptr = lane_ptr;
+    this->target_lane_ptr = nullptr;
 
     // Set the maximum speed of the Vehicle
-    this->max_speed = inputs.max_speed;
+    this->max_speed = class_ptr != nullptr ? class_ptr->max_speed : inputs.max_speed;
 
     // Set the initial speed of the Vehicle to the maximum speed
     this->speed = this->max_speed;
@@ -42,28 +51,52 @@ Vehicle::Vehicle(Lane *lane_ptr, const int id, const int initial_position, const
     this->look_other_backward = inputs.look_other_backward;
 
     // Set the slow down probability of the Vehicle
-    this->prob_slow_down = inputs.prob_slow_down;
+    this->prob_slow_down = class_ptr != nullptr ? class_ptr->prob_slow_down : inputs.prob_slow_down;
 
     // Set the lane change probability of the Vehicle
-    this->prob_change = inputs.prob_change;
+    this->prob_change = class_ptr != nullptr ? class_ptr->prob_change : inputs.prob_change;
+
+    // Set the passing rule of the lane switches of the Vehicle
+    this->passing_rule = inputs.passing_rule;
+
+    // Set whether the Vehicle wraps around to the start of the Lane instead of leaving the Road at its end
+    this->periodic = inputs.boundary == BOUNDARY_PERIODIC;
+    this->wrapped = false;
+    this->exited = false;
 
     // Initialize the time spend on the Road
     this->time_on_road = 0;
 }
 
+/**
+ * Draws a uniform random number for an event of the Vehicle, keyed by its id and age when the simulation has a seed
+ * @param stream the kind of the event
+ * @param age the number of steps the Vehicle was on the Road at the start of the step of the event
+ * @return the random number
+ */
+double Vehicle::drawRandom(const int stream, const int age) const {
+    if (this->random.isEnabled()) {
+        return this->random.draw(this->id, age, stream);
+    }
+    return static_cast<double>(rand()) / static_cast<double>(RAND_MAX);
+}
+
 /**
  * Update the perceived gaps between the Vehicle and the surrounding Vehicles in the Road
  * @param road_ptr pointer to the Road that the Vehicle is in
  * @return 0 if successful, nonzero otherwise
 
  */
-int Vehicle::updateGaps(Road *road_ptr) {
-    // Locate the preceding Vehicle and update the forward gap
-    this->gap_forward = this->lane_ptr->getSize() - 1;
-    for (int i = this->position + 1; i < this->lane_ptr->getSize(); i++) {
-        if (this->lane_ptr->hasVehicleInSite(i)) {
-            this->gap_forward = i - this->position - 1;
-            break;
+int Vehicle::updateGaps(const Road *road_ptr) {
+    const int size = this->lane_ptr->getSize();
+
+    // Locate the preceding Vehicle and update the forward gap, continuing from the start of the Lane on a ring road
+    this->gap_forward = size - 1;
+    if (const int ahead = this->lane_ptr->findVehicleAhead(this->position + 1); ahead >= 0) {
+        this->gap_forward = ahead - this->position - 1;
+    } else if (this->periodic) {
+        if (const int first = this->lane_ptr->findVehicleAhead(0); first >= 0) {
+            this->gap_forward = first + size - this->position - 1;
         }
     }
 
@@ -71,29 +104,34 @@ int Vehicle::updateGaps(Road *road_ptr) {
     this->look_forward = this->speed + 1;
     this->look_other_forward = this->look_forward;
 
-    // Determine the other lane of interest
-    Lane *other_lane_ptr;
-    if (this->lane_ptr->getLaneNumber() == 0) {
-        other_lane_ptr = road_ptr->getLanes()[1];
-    } else {
-        other_lane_ptr = road_ptr->getLanes()[0];
-    }
+    // Update the gaps in each neighbour Lane of interest, which a long Vehicle needs free along its whole length, so the
+    // forward gap is negative when a Vehicle is beside it
+    const int rear = this->getRear();
+    const std::array<Lane *, 2> &neighbour_lanes = road_ptr->getNeighbourLanes(this->lane_ptr->getLaneNumber());
+    for (int side = SIDE_RIGHT; side <= SIDE_LEFT; side++) {
+        const Lane *other_lane_ptr = neighbour_lanes[side];
+        if (other_lane_ptr == nullptr) {
+            continue;
+        }
 
-    // Update the forward gap in the other lane
-    this->gap_other_forward = this->lane_ptr->getSize() - 1;
-    for (int i = this->position; i < this->lane_ptr->getSize(); i++) {
-        if (other_lane_ptr->hasVehicleInSite(i)) {
-            this->gap_other_forward = i - this->position - 1;
-            break;
+        // Update the forward gap in the other lane
+        this->gap_other_forward[side] = size - 1;
+        if (const int ahead = other_lane_ptr->findVehicleAhead(rear); ahead >= 0) {
+            this->gap_other_forward[side] = ahead - this->position - 1;
+        } else if (this->periodic) {
+            if (const int first = other_lane_ptr->findVehicleAhead(0); first >= 0) {
+                this->gap_other_forward[side] = first + size - this->position - 1;
+            }
         }
-    }
 
-    // Update the backward gap in the other lane
-    this->gap_other_backward = this->lane_ptr->getSize() - 1;
-    for (int i = this->position; i >= 0; i--) {
-        if (other_lane_ptr->hasVehicleInSite(i)) {
-            this->gap_other_backward = this->position - i - 1;
-            break;
+        // Update the backward gap in the other lane
+        this->gap_other_backward[side] = size - 1;
+        if (const int behind = other_lane_ptr->findVehicleBehind(rear); behind >= 0) {
+            this->gap_other_backward[side] = rear - behind - 1;
+        } else if (this->periodic) {
+            if (const int last = other_lane_ptr->findVehicleBehind(size - 1); last >= 0) {
+                this->gap_other_backward[side] = rear + size - last - 1;
+            }
         }
     }
 
@@ -102,38 +140,64 @@ int Vehicle::updateGaps(Road *road_ptr) {
 }
 
 /**
- * Moved the Vehicle to the other Lane in the Road
+ * Selects the neighbour Lane that the Vehicle would switch to based on its gaps and the passing rule. The left Lane is
+ * preferred over the right one. With the symmetric rule the Vehicle only switches if it is blocked in its Lane, while
+ * with the asymmetric rule it only passes on the left and returns to the right Lane whenever there is room.
  * @param road_ptr pointer to the Road in which the Vehicle is on
- * @return 0 if successful, nonzero otherwise
+ * @return pointer to the Lane to switch to, null if the Vehicle stays in its Lane
  */
-int Vehicle::performLaneSwitch(Road *road_ptr) {
-    // Evaluate if the Vehicle will change lanes and then perform the lane change
-    if (this->gap_forward < this->look_forward &&
-        this->gap_other_forward > this->look_other_forward &&
-        this->gap_other_backward > this->look_other_backward &&
-        static_cast<double>(rand()) / static_cast<double>(RAND_MAX) <= this->prob_change) {
-        // Determine the lane that the Vehicle is switching to
-        Lane *other_lane_ptr;
-        if (this->lane_ptr->getLaneNumber() == 0) {
-            other_lane_ptr = road_ptr->getLanes()[1];
-        } else {
-            other_lane_ptr = road_ptr->getLanes()[0];
+Lane *Vehicle::selectTargetLane(const Road *road_ptr) const {
+    const bool blocked = this->gap_forward < this->look_forward;
+    const std::array<Lane *, 2> &neighbour_lanes = road_ptr->getNeighbourLanes(this->lane_ptr->getLaneNumber());
+    for (int side = SIDE_LEFT; side >= SIDE_RIGHT; side--) {
+        if (neighbour_lanes[side] == nullptr) {
+            continue;
+        }
+        if (!blocked && !(this->passing_rule == PASSING_ASYMMETRIC && side == SIDE_RIGHT)) {
+            continue;
+        }
+        if (this->gap_other_forward[side] > this->look_other_forward &&
+            this->gap_other_backward[side] > this->look_other_backward) {
+            return neighbour_lanes[side];
         }
+    }
+    return nullptr;
+}
 
-#ifdef DEBUG
-        std::cout << "vehicle " << this->id << " switched lane " << this->lane_ptr->getLaneNumber() << " -> "
-                << other_lane_ptr->getLaneNumber() << std::endl;
-#endif
+/**
+ * Proposes the lane switch of the Vehicle in the current step from its gaps and a random draw, without moving it: the
+ * target Lane is remembered until the Lane it targets resolves the conflicting proposals and commits the switch
+ * @param road_ptr pointer to the Road in which the Vehicle is on
+ * @return 0 if successful, nonzero otherwise
+ */
+int Vehicle::proposeLaneSwitch(const Road *road_ptr) {
+    this->target_lane_ptr = nullptr;
+    Lane *other_lane_ptr = this->selectTargetLane(road_ptr);
+    if (other_lane_ptr != nullptr && this->drawRandom(STREAM_SWITCH, this->time_on_road) <= this->prob_change) {
+        this->target_lane_ptr = other_lane_ptr;
+    }
 
-        // Copy the Vehicle pointer to the other Lane
-        other_lane_ptr->addVehicle(this->position, this);
+    // Return with zero errors
+    return 0;
+}
 
-        // Remove the Vehicle pointer from the current Lane
-        this->lane_ptr->removeVehicle(this->position);
+/**
+ * Rejects the proposed lane switch of the Vehicle, which yields the site it targeted and stays in its Lane
+ * @return 0 if successful, nonzero otherwise
+ */
+int Vehicle::rejectLaneSwitch() {
+    this->target_lane_ptr = nullptr;
 
-        // Set the pointer to the Lane in the Vehicle to the new lane
-        this->lane_ptr = other_lane_ptr;
-    }
+    // Return with zero errors
+    return 0;
+}
+
+/**
+ * Moves the Vehicle to the Lane of its accepted lane switch, whose sites the Lane updates itself
+ * @return 0 if successful, nonzero otherwise
+ */
+int Vehicle::commitLaneSwitch() {
+    this->lane_ptr = this->target_lane_ptr;
 
     // Return with zero errors
     return 0;
@@ -164,7 +228,7 @@ int Vehicle::performLaneMove() {
 #endif
 
     if (this->speed > 0) {
-        if (static_cast<double>(rand()) / static_cast<double>(RAND_MAX) <= this->prob_slow_down) {
+        if (this->drawRandom(STREAM_SLOW_DOWN, this->time_on_road - 1) <= this->prob_slow_down) {
             this->speed--;
 #ifdef DEBUG
             std::cout << "vehicle " << this->id << " decreased speed " << this->speed + 1 << " -> " << this->speed
@@ -173,18 +237,23 @@ int Vehicle::performLaneMove() {
         }
     }
 
+    this->wrapped = false;
     if (this->speed > 0) {
         // Compute the new position of the vehicle
         const int new_position = (this->position + this->speed) % this->lane_ptr->getSize();
 
+        // On a ring road the Vehicle continues from the start of the Lane when it reaches the end
+        this->wrapped = this->periodic && this->position > new_position;
+
         // If the vehicle reached the end of the road, remove the Vehicle from the Lane and return the time on road
-        if (this->position > new_position) {
+        if (this->position > new_position && !this->periodic) {
 #ifdef DEBUG
             std::cout << "vehicle " << this->id << " spent " << this->time_on_road << " steps on the road" << std::endl;
 #endif
 
             // Remove vehicle from the Road
-            this->lane_ptr->removeVehicle(this->position);
+            this->lane_ptr->vacateSites(this);
+            this->exited = true;
 
             // TODO: Send vehicle to next process or if last process remove it
 
@@ -196,14 +265,12 @@ int Vehicle::performLaneMove() {
         std::cout << "vehicle " << this->id << " moved " << this->position << " -> " << new_position << std::endl;
 #endif
 
-        // Update Vehicle position in the Lane object sites
-        this->lane_ptr->addVehicle(new_position, this);
-
-        // Remove vehicle from the old site
-        this->lane_ptr->removeVehicle(this->position);
+        // Remove vehicle from the old sites
+        this->lane_ptr->vacateSites(this);
 
-        // Update the Vehicle position value
+        // Update the Vehicle position value and its sites in the Lane object
         this->position = new_position;
+        this->lane_ptr->occupySites(this);
     }
 
     // Return with no errors
@@ -218,6 +285,90 @@ int Vehicle::getId() const {
     return this->id;
 }
 
+/**
+ * Getter method for the class of the Vehicle
+ * @return the number of the class of the Vehicle, 0 without classes
+ */
+int Vehicle::getClass() const {
+    return this->vehicle_class;
+}
+
+/**
+ * Getter method for the number of sites the Vehicle occupies
+ * @return the length of the Vehicle
+ */
+int Vehicle::getLength() const {
+    return this->length;
+}
+
+/**
+ * Getter method for the site of the Vehicle in its Lane
+ * @return the site of the Vehicle
+ */
+int Vehicle::getPosition() const {
+    return this->position;
+}
+
+/**
+ * Getter method for the last site the Vehicle occupies in its Lane, which is its position for a Vehicle of one site. The
+ * rear of a long Vehicle that has not fully entered the open road is the first site of the Lane.
+ * @return the rear site of the Vehicle
+ */
+int Vehicle::getRear() const {
+    if (this->periodic) {
+        return (this->position - this->length + 1 + this->lane_ptr->getSize()) % this->lane_ptr->getSize();
+    }
+    return std::max(this->position - this->length + 1, 0);
+}
+
+/**
+ * Getter method for the speed of the Vehicle
+ * @return the speed of the Vehicle
+ */
+int Vehicle::getSpeed() const {
+    return this->speed;
+}
+
+/**
+ * Getter method for the number of steps the Vehicle has spent on the Road
+ * @return the number of steps
+ */
+int Vehicle::getTimeOnRoad() const {
+    return this->time_on_road;
+}
+
+/**
+ * Checks whether the Vehicle wrapped around from the end to the start of its Lane in its last lane move
+ * @return whether the Vehicle wrapped around
+ */
+bool Vehicle::hasWrapped() const {
+    return this->wrapped;
+}
+
+/**
+ * Checks whether the Vehicle left the end of the open road
+ * @return whether the Vehicle left the Road
+ */
+bool Vehicle::hasExited() const {
+    return this->exited;
+}
+
+/**
+ * Getter method for the Lane that contains the Vehicle
+ * @return pointer to the Lane of the Vehicle
+ */
+Lane *Vehicle::getLane() const {
+    return this->lane_ptr;
+}
+
+/**
+ * Getter method for the Lane the Vehicle proposed to switch to in the current step
+ * @return pointer to the target Lane, null if the Vehicle stays in its Lane
+ */
+Lane *Vehicle::getTargetLane() const {
+    return this->target_lane_ptr;
+}
+
 /**
  * Getter method for the total time the Vehicle has spent on the Road
  * @param inputs
@@ -239,12 +390,26 @@ int Vehicle::setSpeed(const int speed) {
     return 0;
 }
 
+/**
+ * Setter method for the number of steps the Vehicle has spent on the Road, for a Vehicle continuing its trip from
+ * another Road
+ * @param time_on_road the number of steps
+ * @return 0 if successful, nonzero otherwise
+ */
+int Vehicle::setTimeOnRoad(const int time_on_road) {
+    this->time_on_road = time_on_road;
+
+    // Return with no errors
+    return 0;
+}
+
 /**
  * Debug method for printing the gap information of the Vehicle
  */
 #ifdef DEBUG
 void Vehicle::printGaps() const {
     std::cout << "vehicle " << std::setw(2) << this->id << " gaps, >:" << this->gap_forward << " ^>:"
-            << this->gap_other_forward << " ^<:" << this->gap_other_backward << std::endl;
+            << this->gap_other_forward[SIDE_LEFT] << " ^<:" << this->gap_other_backward[SIDE_LEFT] << " v>:"
+            << this->gap_other_forward[SIDE_RIGHT] << " v<:" << this->gap_other_backward[SIDE_RIGHT] << std::endl;
 }
 #endif
@@ -5,50 +5,92 @@
 #ifndef CA_TRAFFIC_SIMULATION_VEHICLE_H
 #define CA_TRAFFIC_SIMULATION_VEHICLE_H
 
+#include <array>
+
 #include "Inputs.h"
 #include "Road.h"
 #include "Statistic.h"
+#include "KeyedRandom.h"
 
 // Forward declarations
 class Lane;
 
 /**
  * Constructor for a Vehicle in the simulation. Has methods for performing movements based on the CA rules of the
- * simulation.
+ * simulation. A Vehicle of a class longer than one site occupies its position and the sites behind it, and follows the
+ * maximum speed and probabilities of its class.
  */
 class Vehicle {
     Lane *lane_ptr;
+    Lane *target_lane_ptr;
     int id;
+    int vehicle_class;
+    int length;
     int position;
     int speed;
     int max_speed;
     int gap_forward{};
-    int gap_other_forward{};
-    int gap_other_backward{};
+    std::array<int, 2> gap_other_forward{};
+    std::array<int, 2> gap_other_backward{};
     int look_forward;
     int look_other_forward;
     int look_other_backward;
     double prob_slow_down;
     double prob_change;
+    int passing_rule;
+    bool periodic;
+    bool wrapped;
+    bool exited;
     int time_on_road;
+    KeyedRandom random;
+
+    [[nodiscard]] Lane *selectTargetLane(const Road *road_ptr) const;
+
+    [[nodiscard]] double drawRandom(int stream, int age) const;
 
 public:
-    Vehicle(Lane *lane_ptr, int id, int initial_position, const Inputs &inputs);
+    Vehicle(Lane *lane_ptr, int id, int initial_position, const Inputs &inputs, int vehicle_class);
 
     ~Vehicle() = default;
 
-    int updateGaps(Road *road_ptr);
+    int updateGaps(const Road *road_ptr);
+
+    int proposeLaneSwitch(const Road *road_ptr);
 
-    int performLaneSwitch(Road *road_ptr);
+    int rejectLaneSwitch();
+
+    int commitLaneSwitch();
 
     int performLaneMove();
 
     [[nodiscard]] int getId() const;
 
+    [[nodiscard]] int getClass() const;
+
+    [[nodiscard]] int getLength() const;
+
+    [[nodiscard]] int getPosition() const;
+
+    [[nodiscard]] int getRear() const;
+
+    [[nodiscard]] int getSpeed() const;
+
+    [[nodiscard]] int getTimeOnRoad() const;
+
+    [[nodiscard]] bool hasWrapped() const;
+
+    [[nodiscard]] bool hasExited() const;
+
+    [[nodiscard]] Lane *getLane() const;
+
+    [[nodiscard]] Lane *getTargetLane() const;
+
     [[nodiscard]] double getTravelTime(const Inputs &inputs) const;
 
     int setSpeed(int speed);
 
+    int setTimeOnRoad(int time_on_road);
+
 #ifdef DEBUG
     void printGaps() const;
 #endif
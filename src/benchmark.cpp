@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "Inputs.h"
+#include "ProcessData.h"
+#include "SweepEngine.h"
+
+/**
+ * Structure for an open road scenario of the kernel benchmark, with the interarrival CDF of "interarrival-cdf.dat" when
+ * none is given, and initially filled with a fraction of its sites like the ring road
+ */
+struct BenchmarkScenario {
+    std::string name;
+    int num_lanes;
+    int length;
+    std::vector<float> interarrival_times;
+    std::vector<float> interarrival_probabilities;
+    double percent_full;
+};
+
+/**
+ * Runs a scenario with one kernel of the fused lane sweep engine, stepping and spawning like the Simulation
+ * @param inputs instance of the Inputs class with the inputs of the scenario and the kernel
+ * @param percent_full the fraction of the sites of the Road initially occupied
+ * @param num_steps the number of steps
+ * @param speeds_ptr pointer to the speeds of the sites of all the Lanes after the steps, one Lane after the other
+ * @return the run time of the steps in seconds
+ */
+double runKernel(const Inputs &inputs, const double percent_full, const int num_steps,
+                 std::vector<int8_t> *speeds_ptr) {
+    auto *engine_ptr = new SweepEngine(inputs, ProcessData(0, 1));
+    int next_id = 0;
+    engine_ptr->populate(percent_full, &next_id);
+    std::vector<int> travel_times;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int time = 0; time < num_steps; time++) {
+        engine_ptr->step(time, &travel_times);
+        engine_ptr->attemptSpawn(time + 1, &next_id);
+        travel_times.clear();
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    speeds_ptr->clear();
+    for (int i = 0; i < inputs.num_lanes; i++) {
+        const Span<int8_t> speeds = engine_ptr->getLaneSpeeds(i);
+        speeds_ptr->insert(speeds_ptr->end(), speeds.begin(), speeds.end());
+    }
+    delete engine_ptr;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()) / 1000000.0;
+}
+
+/**
+ * Benchmark of the specialised kernels of the fused lane sweep engine against its generic kernel, which runs each
+ * scenario with both kernels and the same keyed random numbers, checks that they end in the same state and prints the
+ * density of the Vehicles and the speedup. It reads "interarrival-cdf.dat" from the current directory for the long
+ * roads, and feeds the short one with a heavy inflow. These sparse roads mostly measure the skipping of the empty
+ * chunks, so the long roads are also run densely filled, where every site is swept and the speedup is the one of the
+ * kernels themselves. The ring road, filled the same way, always runs the lane parallel passes instead of the kernels.
+ * @param argc number of command line arguments
+ * @param argv command line arguments, optionally the number of steps (1000 by default) and the maximum speed (5 by
+ *             default)
+ * @return 0 if the kernels agree on all the scenarios, nonzero otherwise
+ */
+int main(int argc, char **argv) {
+    const int num_steps = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const int max_speed = argc > 2 ? std::stoi(argv[2]) : 5;
+    MPI_Init(&argc, &argv);
+
+    const std::vector<BenchmarkScenario> scenarios = {
+        {"100000 sites, 2 lanes", 2, 100000, {}, {}, 0.0},
+        {"100000 sites, 4 lanes", 4, 100000, {}, {}, 0.0},
+        {"5000 sites, 2 lanes, heavy inflow", 2, 5000, {0.5f, 1.0f}, {0.5f, 1.0f}, 0.0},
+        {"100000 sites, 2 lanes, 40% full", 2, 100000, {}, {}, 0.4},
+        {"100000 sites, 4 lanes, 40% full", 4, 100000, {}, {}, 0.4}
+    };
+    int status = 0;
+    std::cout << "kernel benchmark: " << num_steps << " steps, max_speed=" << max_speed << std::endl;
+    for (const auto &scenario: scenarios) {
+        Inputs inputs;
+        inputs.num_lanes = scenario.num_lanes;
+        inputs.length = scenario.length;
+        inputs.interarrival_times = scenario.interarrival_times;
+        inputs.interarrival_probabilities = scenario.interarrival_probabilities;
+        inputs.max_speed = max_speed;
+        inputs.look_forward = max_speed + 1;
+        inputs.look_other_forward = max_speed + 1;
+        inputs.look_other_backward = max_speed;
+        inputs.prob_slow_down = 0.54;
+        inputs.prob_change = 1.0;
+        inputs.max_time = num_steps;
+        inputs.step_size = 1.464;
+        inputs.warmup_time = 0;
+        inputs.engine = ENGINE_SWEEP;
+        inputs.seed = 1;
+        if (inputs.validate() != 0) {
+            status = 1;
+            break;
+        }
+
+        // Run the generic kernel, then the specialised one
+        std::vector<int8_t> generic_speeds;
+        std::vector<int8_t> specialised_speeds;
+        inputs.kernel = 1;
+        const double generic_time = runKernel(inputs, scenario.percent_full, num_steps, &generic_speeds);
+        inputs.kernel = 0;
+        const double specialised_time = runKernel(inputs, scenario.percent_full, num_steps, &specialised_speeds);
+        const bool agree = generic_speeds == specialised_speeds;
+        const auto num_vehicles = std::count_if(specialised_speeds.begin(), specialised_speeds.end(),
+                                                [](const int8_t speed) { return speed >= 0; });
+        std::cout << std::left << std::setw(34) << scenario.name << std::right << "density="
+                << static_cast<double>(num_vehicles) / static_cast<double>(specialised_speeds.size())
+                << ", generic=" << generic_time
+                << " [s], specialised=" << specialised_time << " [s], speedup=" << generic_time / specialised_time
+                << (agree ? "" : ", DIFFERENT RESULTS") << std::endl;
+        if (!agree) {
+            status = 1;
+        }
+    }
+
+    MPI_Finalize();
+    return status;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <iostream>
+#include <vector>
+
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
+#include "mpi/mpi.h"
+#endif
+#include "Inputs.h"
+#include "ProcessData.h"
+#include "SweepEngine.h"
+
+/**
+ * Runs a filled open road of the fused lane sweep engine without inflow until all its Vehicles left it, with every
+ * Vehicle switching Lanes whenever it can, and checks that the sweeps skip all the chunks of the empty Road
+ * @param num_threads the number of threads, 1 for the single sweep and more for the parallel passes
+ * @param seed the seed of the keyed random numbers, 0 for the random number generators of the Lanes
+ * @return 0 if all the chunks are skipped, nonzero otherwise
+ */
+int checkEmptyRoad(const int num_threads, const unsigned long long seed) {
+    Inputs inputs;
+    inputs.num_lanes = 3;
+    inputs.length = 2000;
+    inputs.max_speed = 5;
+    inputs.look_forward = 6;
+    inputs.look_other_forward = 6;
+    inputs.look_other_backward = 5;
+    inputs.prob_slow_down = 0.2;
+    inputs.prob_change = 1.0;
+    inputs.max_time = 0;
+    inputs.step_size = 1.464;
+    inputs.warmup_time = 0;
+    inputs.engine = ENGINE_SWEEP;
+    inputs.num_threads = num_threads;
+    inputs.seed = seed;
+    inputs.interarrival_times = {1.0f};
+    inputs.interarrival_probabilities = {1.0f};
+    if (inputs.validate() != 0) {
+        return 1;
+    }
+
+    // Fill the Road and step it without spawning until it is empty, and once more to mark the chunks of the empty Road
+    SweepEngine engine(inputs, ProcessData(0, 1));
+    int next_id = 0;
+    engine.populate(0.3, &next_id);
+    std::vector<int> travel_times;
+    int time = 0;
+    while (engine.getNumVehicles() > 0 && time < 10 * inputs.length) {
+        engine.step(time++, &travel_times);
+    }
+    engine.step(time, &travel_times);
+
+    std::cout << "threads=" << num_threads << ", seed=" << seed << ": " << travel_times.size() << " of " << next_id
+            << " vehicles left the road after " << time << " steps, " << engine.getNumActiveChunks()
+            << " active chunks" << std::endl;
+    if (engine.getNumVehicles() != 0 || static_cast<int>(travel_times.size()) != next_id) {
+        std::cout << "error: the vehicles did not all leave the road!" << std::endl;
+        return 1;
+    }
+    if (engine.getNumActiveChunks() != 0) {
+        std::cout << "error: the sweeps visit chunks of the empty road!" << std::endl;
+        return 1;
+    }
+
+    // Return with no errors
+    return 0;
+}
+
+/**
+ * Test of the skipping of the empty chunks of sites by the fused lane sweep engine after lane switches, with the single
+ * sweep and the parallel passes
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @return 0 if the chunks of the empty Road are all skipped, nonzero otherwise
+ */
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    int status = 0;
+    for (const int num_threads: {1, 2}) {
+        for (const unsigned long long seed: {0ULL, 1ULL}) {
+            if (checkEmptyRoad(num_threads, seed) != 0) {
+                status = 1;
+            }
+        }
+    }
+    MPI_Finalize();
+    return status;
+}
@@ -4,10 +4,16 @@
 
 #include <iostream>
 
+#ifdef NO_MPI
+#include "SerialMPI.h"
+#else
 #include "mpi/mpi.h"
+#endif
 #include "Inputs.h"
 #include "ProcessData.h"
-#include "Simulation.h"
+#include "AutoTuner.h"
+#include "Experiment.h"
+#include "GoldenReference.h"
 
 /**
  * Main point of execution of the program
@@ -22,6 +28,7 @@ int main(int argc, char **argv) {
 
     int rank, size;
     auto inputs = Inputs();
+    auto paired_inputs = Inputs();
 
     // Initialize the MPI environment and obtain the rank and size of the process
     MPI_Init(&argc, &argv);
@@ -35,23 +42,45 @@ int main(int argc, char **argv) {
         std::cout << "================================================" << std::endl;
     }
 
-    // Create an Inputs object to contain the simulation parameters
-    if (inputs.loadFromFile() != 0) {
+    // Create an Inputs object to contain the simulation parameters, and one for the paired scenario if there is one
+    if (inputs.loadFromFile("cats-input.txt") != 0) {
+        return 1;
+    }
+    if (inputs.paired_scenario != 0 && paired_inputs.loadFromFile("cats-input-paired.txt") != 0) {
         return 1;
     }
 
-    // Create a Simulation object for the current simulation
-    auto *simulation_ptr = new Simulation(inputs, ProcessData(rank, size));
+    // Pick the fastest configuration of the engine for the scenario, the paired scenario running with the same one
+    if (inputs.tune_steps > 0 && inputs.golden_reference == 0) {
+        const auto auto_tuner = AutoTuner(inputs, ProcessData(rank, size));
+        auto_tuner.tune(&inputs);
+        paired_inputs.engine = inputs.engine;
+        paired_inputs.num_threads = inputs.num_threads;
+        paired_inputs.kernel = inputs.kernel;
+        paired_inputs.halo_interval = inputs.halo_interval;
+    }
+
+    // Check the engines against the reference engine instead of running the simulation if requested
+    int status = 0;
+    if (inputs.golden_reference != 0) {
+        const auto golden_reference = GoldenReference(ProcessData(rank, size));
+        status = golden_reference.run();
+        MPI_Finalize();
+        return status;
+    }
+
+    // Create an Experiment object for the replicas of the current simulation
+    auto *experiment_ptr = new Experiment(inputs, paired_inputs, ProcessData(rank, size));
 
-    // Run the Simulation
-    simulation_ptr->run_simulation();
+    // Run the Experiment
+    experiment_ptr->run();
 
-    // Delete the Simulation object
-    delete simulation_ptr;
+    // Delete the Experiment object
+    delete experiment_ptr;
 
     // Finalize the MPI environment
     MPI_Finalize();
 
     // Return with no errors
-    return 0;
+    return status;
 }
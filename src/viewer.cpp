@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2019 Maitreya Venkataswamy - All Rights Reserved
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LiveFeed.h"
+#include "SnapshotFile.h"
+
+// Characters of the bins of the Lanes, from empty to full
+constexpr char DENSITY_CHARACTERS[] = " .:-=#";
+constexpr int NUM_DENSITY_LEVELS = 5;
+
+// Time between two polls of the live feed for a new snapshot
+constexpr std::chrono::milliseconds POLL_INTERVAL(200);
+
+/**
+ * Prints a snapshot of the live feed, the summary counters followed by a bar of each Lane from the highest numbered
+ * one down, like the Road is printed in debug mode, where each character shows the fraction of occupied sites of a bin
+ * @param summary the summary counters of the snapshot
+ * @param bins the number of Vehicles and the sum of their speeds of each bin of each Lane
+ * @param num_lanes the number of Lanes
+ * @param num_bins the number of bins of each Lane
+ */
+void printSnapshot(const FeedSummary &summary, const std::vector<uint32_t> &bins, const int num_lanes,
+                   const int num_bins) {
+    std::cout << "time " << summary.time << ", sites " << summary.lane_offset << " to "
+            << summary.lane_offset + summary.lane_size - 1 << ": " << summary.num_vehicles << " vehicles, "
+            << "time on road avg=" << summary.travel_time << ", flow avg=" << summary.flow << ", mean speed avg="
+            << summary.mean_speed << ", N=" << summary.num_samples << std::endl;
+    const double bin_size = static_cast<double>(summary.lane_size) / num_bins;
+    for (int i = num_lanes - 1; i >= 0; i--) {
+        std::ostringstream lane_string_stream;
+        long num_vehicles = 0;
+        long speed_sum = 0;
+        lane_string_stream << "lane " << std::setw(2) << i << " |";
+        for (int b = 0; b < num_bins; b++) {
+            const uint32_t count = bins[2 * (static_cast<size_t>(i) * num_bins + b)];
+            const int level = bin_size > 0.0 ? static_cast<int>(count * NUM_DENSITY_LEVELS / bin_size + 0.999) : 0;
+            lane_string_stream << DENSITY_CHARACTERS[std::min(level, NUM_DENSITY_LEVELS)];
+            num_vehicles += count;
+            speed_sum += bins[2 * (static_cast<size_t>(i) * num_bins + b) + 1];
+        }
+        lane_string_stream << "| speed avg=";
+        lane_string_stream << (num_vehicles > 0 ? static_cast<double>(speed_sum) / num_vehicles : 0.0);
+        std::cout << lane_string_stream.str() << std::endl;
+    }
+}
+
+/**
+ * Prints the block of a process in a snapshot of the snapshot file, the header of the block followed by each Lane from
+ * the highest numbered one down, with a character per site: the speed of its Vehicle ('+' from 10 up), or '.' if empty
+ * @param block the header of the block
+ * @param speeds the speeds of the sites of each Lane of the process, one Lane after the other
+ * @param num_lanes the number of Lanes
+ */
+void printStoredSnapshot(const SnapshotBlockHeader &block, const std::vector<int8_t> &speeds, const int num_lanes) {
+    std::cout << "time " << block.time << ", sites " << block.lane_offset << " to "
+            << block.lane_offset + block.lane_size - 1 << ": " << block.num_vehicles << " vehicles" << std::endl;
+    for (int i = num_lanes - 1; i >= 0; i--) {
+        std::ostringstream lane_string_stream;
+        lane_string_stream << "lane " << std::setw(2) << i << " |";
+        for (int64_t site = 0; site < block.lane_size; site++) {
+            const int8_t speed = speeds[i * block.lane_size + site];
+            lane_string_stream << (speed < 0 ? '.' : speed < 10 ? static_cast<char>('0' + speed) : '+');
+        }
+        lane_string_stream << "|";
+        std::cout << lane_string_stream.str() << std::endl;
+    }
+}
+
+/**
+ * Reference viewer of the live feed of a simulation process, which prints each new snapshot until the simulation ends
+ * @param argc number of command line arguments
+ * @param argv command line arguments, optionally the rank of the process whose feed to view (0 by default), or the
+ *             name of a snapshot file, the time of a snapshot and optionally the rank of the process to print from it
+ * @return 0 if successful, nonzero otherwise
+ */
+int main(const int argc, char **argv) {
+    // Print the block of a process in a snapshot of a snapshot file instead if one is given
+    if (argc > 2) {
+        SnapshotFile snapshot_file(ProcessData(0, 1));
+        SnapshotBlockHeader block{};
+        std::vector<int8_t> speeds;
+        if (snapshot_file.open(argv[1]) != 0 ||
+            snapshot_file.read(std::stoll(argv[2]), argc > 3 ? std::stoi(argv[3]) : 0, &block, &speeds) != 0) {
+            return 1;
+        }
+        printStoredSnapshot(block, speeds, snapshot_file.getNumLanes());
+        return 0;
+    }
+
+    const int rank = argc > 1 ? std::stoi(argv[1]) : 0;
+
+    // Attach to the live feed of the process
+    LiveFeed feed;
+    if (feed.attach(rank) != 0) {
+        return 1;
+    }
+
+    // Print each new snapshot, including the last one of the finished simulation
+    FeedSummary summary{};
+    std::vector<uint32_t> bins;
+    uint64_t num_printed = 0;
+    while (true) {
+        const bool finished = feed.isFinished();
+        if (const uint64_t num_published = feed.getNumPublished(); num_published != num_printed &&
+                                                                   feed.readLatest(&summary, &bins) == 0) {
+            printSnapshot(summary, bins, feed.getNumLanes(), feed.getNumBins());
+            num_printed = num_published;
+        }
+        if (finished) {
+            break;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+
+    // Return with no errors
+    return 0;
+}